@@ -0,0 +1,180 @@
+"""
+---------------------
+The MIT License (MIT)
+
+Copyright (c) 2020 Terje Io
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+---------------------
+"""
+
+
+"""
+This Python script generates the header used by grblHAL builds with SETTINGS_FROZEN enabled in
+config.h. It reads the output of the `$$` command from a tuned machine and writes the settings as
+overrides of the compile time defaults in defaults.h, turning the global settings into constants.
+
+REQUIREMENTS:
+  - Python 2.7 or 3.x.
+
+USAGE:
+  - Capture the output of `$$` from the machine to a file, e.g. settings.txt.
+  - Run 'python freeze_settings.py settings.txt settings_frozen.h' and copy the header to the
+    grbl folder, or to a folder on the include path of the driver project.
+  - Enable SETTINGS_FROZEN in config.h and rebuild.
+  - Settings that cannot be frozen, such as driver settings, are listed as comments in the header.
+"""
+
+import re
+import sys
+
+AXIS = 'XYZABC'
+
+# $ setting number -> list of (macro, converter) tuples.
+def flag(bit):
+    return lambda v: '1' if int(v) & (1 << bit) else '0'
+
+def integer(v):
+    return str(int(float(v)))
+
+def real(v):
+    return repr(float(v)) + 'f'
+
+def mode(m):
+    return lambda v: '1' if int(v) == m else '0'
+
+SETTINGS = {
+    0:  [('DEFAULT_STEP_PULSE_MICROSECONDS', integer)],
+    1:  [('DEFAULT_STEPPER_IDLE_LOCK_TIME', integer)],
+    2:  [('DEFAULT_STEPPING_INVERT_MASK', integer)],
+    3:  [('DEFAULT_DIRECTION_INVERT_MASK', integer)],
+    4:  [('INVERT_ST_ENABLE_MASK', integer)],
+    5:  [('INVERT_LIMIT_PIN_MASK', integer)],
+    6:  [('DEFAULT_INVERT_PROBE_PIN', integer)],
+    10: [('REPORT_FIELD_BUFFER_STATE', flag(1)),
+         ('REPORT_FIELD_LINE_NUMBERS', flag(2)),
+         ('REPORT_FIELD_CURRENT_FEED_SPEED', flag(3)),
+         ('REPORT_FIELD_PIN_STATE', flag(4)),
+         ('REPORT_FIELD_WORK_COORD_OFFSET', flag(5)),
+         ('REPORT_FIELD_OVERRIDES', flag(6)),
+         ('FORCE_BUFFER_SYNC_DURING_WCO_CHANGE', flag(8))],
+    11: [('DEFAULT_JUNCTION_DEVIATION', real)],
+    12: [('DEFAULT_ARC_TOLERANCE', real)],
+    13: [('DEFAULT_REPORT_INCHES', integer)],
+    14: [('INVERT_CONTROL_PIN_MASK', integer)],
+    15: [('INVERT_COOLANT_FLOOD_PIN', flag(0)),
+         ('INVERT_COOLANT_MIST_PIN', flag(1))],
+    16: [('INVERT_SPINDLE_ENABLE_PIN', flag(0))],
+    17: [('DISABLE_CONTROL_PINS_PULL_UP_MASK', integer)],
+    18: [('DISABLE_LIMIT_PINS_PULL_UP_MASK', integer)],
+    19: [('DISABLE_PROBE_PIN_PULL_UP', integer)],
+    20: [('DEFAULT_SOFT_LIMIT_ENABLE', integer)],
+    21: [('DEFAULT_HARD_LIMIT_ENABLE', flag(0)),
+         ('DEFAULT_CHECK_LIMITS_AT_INIT', flag(1))],
+    22: [('DEFAULT_HOMING_ENABLE', flag(0)),
+         ('HOMING_SINGLE_AXIS_COMMANDS', flag(1)),
+         ('DEFAULT_HOMING_INIT_LOCK', flag(2)),
+         ('HOMING_FORCE_SET_ORIGIN', flag(3))],
+    23: [('DEFAULT_HOMING_DIR_MASK', integer)],
+    24: [('DEFAULT_HOMING_FEED_RATE', real)],
+    25: [('DEFAULT_HOMING_SEEK_RATE', real)],
+    26: [('DEFAULT_HOMING_DEBOUNCE_DELAY', integer)],
+    27: [('DEFAULT_HOMING_PULLOFF', real)],
+    28: [('DEFAULT_G73_RETRACT', real)],
+    29: [('DEFAULT_STEP_PULSE_DELAY', integer)],
+    30: [('DEFAULT_SPINDLE_RPM_MAX', real)],
+    31: [('DEFAULT_SPINDLE_RPM_MIN', real)],
+    32: [('DEFAULT_LASER_MODE', mode(1)),
+         ('DEFAULT_LATHE_MODE', mode(2))],
+    33: [('DEFAULT_SPINDLE_PWM_FREQ', integer)],
+    34: [('DEFAULT_SPINDLE_PWM_OFF_VALUE', real)],
+    35: [('DEFAULT_SPINDLE_PWM_MIN_VALUE', real)],
+    36: [('DEFAULT_SPINDLE_PWM_MAX_VALUE', real)],
+    37: [('ST_DEENERGIZE_MASK', integer)],
+    38: [('DEFAULT_SPINDLE_PPR', integer)],
+    39: [('DEFAULT_LEGACY_RTCOMMANDS', integer)],
+    41: [('DEFAULT_PARKING_ENABLE', flag(0)),
+         ('DEFAULT_DEACTIVATE_PARKING_UPON_INIT', flag(1)),
+         ('DEFAULT_ENABLE_PARKING_OVERRIDE_CONTROL', flag(2))],
+    42: [('DEFAULT_PARKING_AXIS', integer)],
+    43: [('DEFAULT_N_HOMING_LOCATE_CYCLE', integer)],
+    56: [('DEFAULT_PARKING_PULLOUT_INCREMENT', real)],
+    57: [('DEFAULT_PARKING_PULLOUT_RATE', real)],
+    58: [('DEFAULT_PARKING_TARGET', real)],
+    59: [('DEFAULT_PARKING_RATE', real)],
+    62: [('DEFAULT_SLEEP_ENABLE', integer)],
+    63: [('DEFAULT_DISABLE_LASER_DURING_HOLD', flag(0)),
+         ('DEFAULT_RESTORE_AFTER_FEED_HOLD', flag(1))],
+    64: [('DEFAULT_FORCE_INITIALIZATION_ALARM', integer)],
+    65: [('ALLOW_FEED_OVERRIDE_DURING_PROBE_CYCLES', integer)],
+}
+
+for cycle in range(6):
+    SETTINGS[44 + cycle] = [('HOMING_CYCLE_%d' % cycle, integer)]
+
+# Axis settings, $100 + 10 * setting + axis. Acceleration is reported in mm/sec^2, stored in mm/min^2.
+for idx, axis in enumerate(AXIS):
+    SETTINGS[100 + idx] = [('DEFAULT_%s_STEPS_PER_MM' % axis, real)]
+    SETTINGS[110 + idx] = [('DEFAULT_%s_MAX_RATE' % axis, real)]
+    SETTINGS[120 + idx] = [('DEFAULT_%s_ACCELERATION' % axis, lambda v: '(%sf * 60.0f * 60.0f)' % repr(float(v)))]
+    SETTINGS[130 + idx] = [('DEFAULT_%s_MAX_TRAVEL' % axis, real)]
+
+def parse(lines):
+    settings = {}
+    for line in lines:
+        m = re.match(r'\s*\$(\d+)=([^\s(]*)', line)
+        if m:
+            settings[int(m.group(1))] = m.group(2)
+    return settings
+
+def generate(settings):
+    out = ['/*',
+           '  settings_frozen.h - frozen global settings, generated by freeze_settings.py',
+           '',
+           '  Overrides the defaults in defaults.h when SETTINGS_FROZEN is enabled in config.h.',
+           '*/',
+           '']
+    skipped = []
+    for setting in sorted(settings):
+        value = settings[setting]
+        if setting not in SETTINGS:
+            skipped.append('// $%d=%s' % (setting, value))
+            continue
+        try:
+            for macro, convert in SETTINGS[setting]:
+                out += ['#undef %s' % macro, '#define %s %s // $%d' % (macro, convert(value), setting)]
+        except ValueError:
+            skipped.append('// $%d=%s' % (setting, value))
+    if skipped:
+        out += ['', '// Not frozen, driver settings or settings without a compile time default:', ''] + skipped
+    return '\n'.join(out) + '\n'
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        print('Usage: freeze_settings.py <$$ dump> [<output header>]')
+        sys.exit(1)
+
+    with open(sys.argv[1]) as f:
+        header = generate(parse(f))
+
+    if len(sys.argv) > 2:
+        with open(sys.argv[2], 'w') as f:
+            f.write(header)
+    else:
+        sys.stdout.write(header)
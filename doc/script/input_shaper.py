@@ -0,0 +1,136 @@
+"""
+---------------------
+The MIT License (MIT)
+
+Copyright (c) 2020 Terje Io
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+---------------------
+"""
+
+"""
+This Python script computes the impulses of the input shapers used by the segment generator
+when grblHAL is built with INPUT_SHAPING enabled, and prints the residual vibration left by
+each shaper over a range of resonance frequencies. Use it to select the shaper type and to
+check how sensitive the result is to errors in the measured frequency and damping ratio.
+
+REQUIREMENTS:
+  - Python 2.7 or 3.x. Matplotlib is optional, if available a plot of the residual vibration
+    is saved in the working directory as 'input_shaper.png'.
+
+USAGE:
+  - Measure the resonance frequency of the axis, e.g. by ringing test cuts or an accelerometer,
+    and estimate its damping ratio (0.05 - 0.1 is typical for belt driven machines).
+
+  - Run the script with the frequency and damping ratio as arguments:
+
+      python input_shaper.py 42.5 0.1
+
+  - Program the settings for the axis, e.g. for the X-axis and a ZVD shaper:
+
+      $210=42.5
+      $220=0.1
+      $230=1
+
+    Shaper types are 0 = ZV, 1 = ZVD and 2 = EI. Setting the frequency to 0 disables shaping
+    for the axis. Shapers of different axes are combined by convolution by the controller,
+    which adds the shaper durations to the delay reported below.
+"""
+
+import math
+import sys
+
+EI_VTOL = 0.05 # Same as INPUT_SHAPER_EI_VTOL in config.h
+SHAPERS = ('ZV', 'ZVD', 'EI')
+
+def shaper_impulses(shaper, frequency, damping):
+    """Returns the normalized impulse amplitudes and times (s) of a shaper."""
+    d = math.sqrt(1.0 - damping * damping)
+    k = math.exp(-damping * math.pi / d)
+    td = 1.0 / (frequency * d)
+
+    if shaper == 'ZVD':
+        a = [1.0, 2.0 * k, k * k]
+        t = [0.0, 0.5 * td, td]
+    elif shaper == 'EI':
+        a0 = 0.25 * (1.0 + EI_VTOL)
+        a = [a0, 0.5 * (1.0 - EI_VTOL) * k, a0 * k * k]
+        t = [0.0, 0.5 * td, td]
+    else:
+        a = [1.0, k]
+        t = [0.0, 0.5 * td]
+
+    s = sum(a)
+    return [x / s for x in a], t
+
+def residual_vibration(a, t, frequency, damping):
+    """Returns the vibration left by the shaper relative to an unshaped step at frequency."""
+    w = 2.0 * math.pi * frequency
+    wd = w * math.sqrt(1.0 - damping * damping)
+    tn = t[-1]
+    c = sum(ai * math.exp(damping * w * (ti - tn)) * math.cos(wd * ti) for ai, ti in zip(a, t))
+    s = sum(ai * math.exp(damping * w * (ti - tn)) * math.sin(wd * ti) for ai, ti in zip(a, t))
+    return math.sqrt(c * c + s * s)
+
+def main():
+    if len(sys.argv) < 2:
+        print('Usage: python input_shaper.py <frequency (Hz)> [damping ratio]')
+        sys.exit(1)
+
+    frequency = float(sys.argv[1])
+    damping = float(sys.argv[2]) if len(sys.argv) > 2 else 0.1
+
+    if frequency < 1.0 or not 0.0 <= damping < 1.0:
+        print('Frequency must be >= 1 Hz and damping ratio in the range 0 - 0.99')
+        sys.exit(1)
+
+    ratios = [0.5 + 0.05 * i for i in range(31)]
+    curves = {}
+
+    for idx, shaper in enumerate(SHAPERS):
+        a, t = shaper_impulses(shaper, frequency, damping)
+        print('%s ($23x=%d), delay %.1f ms' % (shaper, idx, t[-1] * 1000.0))
+        for ai, ti in zip(a, t):
+            print('  A = %.4f  t = %.2f ms' % (ai, ti * 1000.0))
+        curves[shaper] = [residual_vibration(a, t, frequency * r, damping) * 100.0 for r in ratios]
+
+    print('')
+    print('Residual vibration (%) vs. actual resonance frequency')
+    print('%10s' % 'Hz' + ''.join('%8s' % s for s in SHAPERS))
+    for i, r in enumerate(ratios):
+        print('%10.1f' % (frequency * r) + ''.join('%8.1f' % curves[s][i] for s in SHAPERS))
+
+    try:
+        import matplotlib
+        matplotlib.use('Agg')
+        import matplotlib.pyplot as plt
+    except ImportError:
+        return
+
+    for shaper in SHAPERS:
+        plt.plot([frequency * r for r in ratios], curves[shaper], label=shaper)
+    plt.xlabel('Resonance frequency (Hz)')
+    plt.ylabel('Residual vibration (%)')
+    plt.title('Input shaper sensitivity, %.1f Hz, damping %.2f' % (frequency, damping))
+    plt.legend()
+    plt.grid(True)
+    plt.savefig('input_shaper.png')
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,199 @@
+"""
+---------------------
+The MIT License (MIT)
+
+Copyright (c) 2020 Terje Io
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+---------------------
+"""
+
+
+"""
+This Python script simulates the stepper ISR and segment generator for a single two axis motion
+and compares the step output of the Bresenham line tracer with AMASS, the default, with the per
+axis DDA step generator enabled by STEP_GENERATOR_DDA in config.h. For each algorithm it prints
+the number of steps output per axis, the number of ISR ticks and the peak ISR rate, and the
+timing jitter of the steps relative to the ideal step times of the motion.
+
+REQUIREMENTS:
+  - Python 2.7 or 3.x, no additional libraries required.
+
+USAGE:
+  - Run the script with the axis step counts, the dominant axis step rate (Hz) and optionally
+    the acceleration (steps/s^2) and the stepper timer frequency (Hz):
+
+      python step_generator.py 4000 1300 2000 20000 1000000
+
+  - Use a low step rate to see the ISR load of AMASS overdriving the timer, and a high step rate
+    with a small ratio between the axes to see the aliasing of the non-dominant axis.
+"""
+
+import math
+import sys
+
+ACCELERATION_TICKS_PER_SECOND = 100    # Same as in config.h
+STEP_DDA_TICK_RATE = 4000              # Same as in config.h
+MAX_AMASS_LEVEL = 3
+DDA_PHASE_BITS = 30
+DDA_PHASE_ONE = 1 << DDA_PHASE_BITS
+
+class Profile:
+    """Trapezoidal velocity profile of the dominant axis in steps and seconds."""
+
+    def __init__(self, steps, rate, accel):
+        self.steps = float(steps)
+        self.rate = min(rate, math.sqrt(accel * steps)) # Triangular profile if too short to cruise
+        self.accel = accel
+        self.t_accel = self.rate / accel
+        self.s_accel = 0.5 * self.rate * self.t_accel
+        self.t_cruise = (self.steps - 2.0 * self.s_accel) / self.rate
+        self.duration = 2.0 * self.t_accel + self.t_cruise
+
+    def position(self, t):
+        if t <= 0.0:
+            return 0.0
+        if t < self.t_accel:
+            return 0.5 * self.accel * t * t
+        if t < self.t_accel + self.t_cruise:
+            return self.s_accel + self.rate * (t - self.t_accel)
+        if t < self.duration:
+            td = self.duration - t
+            return self.steps - 0.5 * self.accel * td * td
+        return self.steps
+
+def segments(profile):
+    """Segment generator: yields (start step, steps, duration) for fixed time segments, carrying the
+       time of partial steps over to the next segment like st_prep_buffer() does."""
+    dt_segment = 1.0 / ACCELERATION_TICKS_PER_SECOND
+    t, steps_done, dt_remainder = 0.0, 0, 0.0
+    while steps_done < profile.steps:
+        t_end = min(t + dt_segment, profile.duration)
+        s = profile.position(t_end)
+        n_remaining = int(math.ceil(profile.steps - s - 1e-9))
+        n_step = int(profile.steps) - n_remaining - steps_done
+        dt = t_end - t + dt_remainder
+        t = t_end
+        step_dist = s - steps_done
+        inv_rate = dt / step_dist if step_dist > 0.0 else dt
+        yield steps_done, n_step, inv_rate * n_step if n_step else inv_rate
+        dt_remainder = (step_dist - n_step) * inv_rate
+        steps_done += n_step
+
+def bresenham(axis_steps, profile, f_timer):
+    """Bresenham line tracer with AMASS, returns per axis step times, executed segments, ticks and peak ISR rate."""
+    level_1, level_2, level_3 = f_timer // 8000, f_timer // 4000, f_timer // 2000
+    event_count = max(axis_steps) << MAX_AMASS_LEVEL
+    steps = [s << MAX_AMASS_LEVEL for s in axis_steps]
+    counter = [event_count >> 1] * len(axis_steps)
+    times, executed = [[] for _ in axis_steps], []
+    t, ticks, peak = 0.0, 0, 0.0
+    for pos, n_step, dt in segments(profile):
+        t_start = t
+        cycles = int(math.ceil(f_timer * dt / n_step)) if n_step else int(math.ceil(f_timer * dt))
+        level = 0 if cycles < level_1 else (1 if cycles < level_2 else (2 if cycles < level_3 else 3))
+        cycles >>= level
+        n_ticks = max(n_step << level, 1)
+        rate = [s >> level for s in steps]
+        peak = max(peak, float(f_timer) / cycles)
+        for _ in range(n_ticks):
+            t += float(cycles) / f_timer
+            ticks += 1
+            for idx in range(len(steps)):
+                counter[idx] += rate[idx]
+                if counter[idx] > event_count:
+                    counter[idx] -= event_count
+                    times[idx].append(t)
+        executed.append((t_start, t, pos, pos + n_step))
+    return times, executed, ticks, peak
+
+def dda_phase(steps, event_count, pos):
+    q = steps * pos
+    return ((q // event_count) << DDA_PHASE_BITS) + (((q % event_count) << DDA_PHASE_BITS) // event_count)
+
+def dda(axis_steps, profile, f_timer):
+    """Per axis DDA, returns per axis step times, executed segments, ticks and peak ISR rate."""
+    event_count = max(axis_steps)
+    counter = [DDA_PHASE_ONE >> 1] * len(axis_steps)
+    times, executed = [[] for _ in axis_steps], []
+    t, ticks, peak = 0.0, 0, 0.0
+    for pos, n_step, dt in segments(profile):
+        t_start = t
+        phase = [dda_phase(s, event_count, pos + n_step) - dda_phase(s, event_count, pos) for s in axis_steps]
+        n_ticks = max((max(phase) + DDA_PHASE_ONE - 1) >> DDA_PHASE_BITS, int(math.ceil(dt * STEP_DDA_TICK_RATE)), 1)
+        rate = [(p + n_ticks - 1) // n_ticks for p in phase]
+        cycles = int(math.ceil(f_timer * dt / n_ticks))
+        peak = max(peak, float(f_timer) / cycles)
+        for _ in range(n_ticks):
+            t += float(cycles) / f_timer
+            ticks += 1
+            for idx in range(len(axis_steps)):
+                counter[idx] += rate[idx]
+                if counter[idx] > DDA_PHASE_ONE:
+                    counter[idx] -= DDA_PHASE_ONE
+                    times[idx].append(t)
+        executed.append((t_start, t, pos, pos + n_step))
+    return times, executed, ticks, peak
+
+def jitter(times, steps, event_count, executed):
+    """Returns RMS and max deviation (us) of the step times from the ideal step times. The ideal
+       times are taken from the executed segments, which have constant speed, so that the timer
+       resolution of the segment step rates does not add up to a drift."""
+    if not times:
+        return 0.0, 0.0
+    err, idx = [], 0
+    for k, t in enumerate(times):
+        # Ideal time: the axis position crosses the middle of the step.
+        pos = (k + 0.5) * event_count / float(steps)
+        while idx < len(executed) - 1 and executed[idx][3] < pos:
+            idx += 1
+        t0, t1, p0, p1 = executed[idx]
+        ideal = t0 + (t1 - t0) * (pos - p0) / (p1 - p0) if p1 > p0 else t0
+        err.append((t - ideal) * 1e6)
+    mean = sum(err) / len(err)
+    rms = math.sqrt(sum((e - mean) ** 2 for e in err) / len(err))
+    return rms, max(abs(e - mean) for e in err)
+
+def main():
+    if len(sys.argv) < 4:
+        print('Usage: python step_generator.py <x steps> <y steps> <rate (Hz)> [accel (steps/s^2)] [timer (Hz)]')
+        sys.exit(1)
+
+    axis_steps = [int(sys.argv[1]), int(sys.argv[2])]
+    rate = float(sys.argv[3])
+    accel = float(sys.argv[4]) if len(sys.argv) > 4 else 20.0 * rate
+    f_timer = int(sys.argv[5]) if len(sys.argv) > 5 else 1000000
+    event_count = max(axis_steps)
+    profile = Profile(event_count, rate, accel)
+
+    print('Motion: %d x %d steps, %.0f Hz peak dominant step rate, %.3f s' % (axis_steps[0], axis_steps[1], profile.rate, profile.duration))
+    print('')
+    print('%-10s %8s %8s %10s %10s %14s %14s' % ('Generator', 'X steps', 'Y steps', 'ISR ticks', 'Peak kHz', 'X jitter us', 'Y jitter us'))
+
+    for name, generator in (('AMASS', bresenham), ('DDA', dda)):
+        times, executed, ticks, peak = generator(axis_steps, profile, f_timer)
+        jx = jitter(times[0], axis_steps[0], event_count, executed)
+        jy = jitter(times[1], axis_steps[1], event_count, executed)
+        print('%-10s %8d %8d %10d %10.1f %6.1f/%-7.1f %6.1f/%-7.1f' % (name, len(times[0]), len(times[1]), ticks, peak / 1000.0, jx[0], jx[1], jy[0], jy[1]))
+
+    print('')
+    print('Jitter is shown as RMS/max deviation from the ideal step times.')
+
+if __name__ == '__main__':
+    main()
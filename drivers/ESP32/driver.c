@@ -77,6 +77,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/timers.h"
+#include "esp_timer.h"
 
 // prescale step counter to 20Mhz
 #define STEPPER_DRIVER_PRESCALER 4
@@ -420,6 +421,12 @@ IRAM_ATTR static void driver_delay_ms (uint32_t ms, void (*callback)(void))
     }
 }
 
+// Returns milliseconds elapsed since startup.
+IRAM_ATTR static uint32_t getElapsedTicks (void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
 #ifdef DEBUGOUT
 static void debug_out (bool enable)
 {
@@ -1364,6 +1371,7 @@ bool driver_init (void)
     hal.f_step_timer = rtc_clk_apb_freq_get() / STEPPER_DRIVER_PRESCALER; // 20 MHz
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -1488,7 +1496,7 @@ bool driver_init (void)
 #endif
 
    // no need to move version check before init - compiler will fail any mismatch for existing entries
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
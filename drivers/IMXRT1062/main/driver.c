@@ -189,6 +189,7 @@ static bool pwmEnabled = false, IOInitDone = false, probe_invert = false;
 static axes_signals_t next_step_outbits;
 static spindle_pwm_t spindle_pwm;
 static delay_t grbl_delay = { .ms = 0, .callback = NULL };
+static volatile uint32_t elapsed_ticks = 0;
 
 static void spindle_set_speed (uint_fast16_t pwm_value);
 
@@ -225,6 +226,11 @@ static void driver_delay_ms (uint32_t ms, void (*callback)(void))
     }
 }
 
+static uint32_t getElapsedTicks (void)
+{
+    return elapsed_ticks;
+}
+
 // Set stepper pulse output pins.
 // step_outbits.value (or step_outbits.mask) are: bit0 -> X, bit1 -> Y...
 // Individual step bits can be accessed by step_outbits.x, step_outbits.y, ...
@@ -1034,6 +1040,7 @@ bool driver_init (void)
     hal.f_step_timer = 24000000;
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -1133,7 +1140,7 @@ bool driver_init (void)
 
     // No need to move version check before init.
     // Compiler will fail any signature mismatch for existing entries.
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -1290,6 +1297,8 @@ static void gpio_isr (void)
 // Interrupt handler for 1 ms interval timer
 static void systick_isr (void)
 {
+    elapsed_ticks++;
+
 #if USB_SERIAL_GRBL == 2
     systick_isr_org();
 //    usb_serial_poll();
@@ -57,6 +57,7 @@ static uint8_t probe_invert_mask;
 static axes_signals_t next_step_outbits;
 static spindle_pwm_t spindle_pwm;
 static delay_t delay = { .ms = 1, .callback = NULL }; // NOTE: initial ms set to 1 for "resetting" systick timer on startup
+static volatile uint32_t elapsed_ticks = 0;
 
 #define DEBOUNCE_QUEUE 8 // Must be a power of 2
 
@@ -207,13 +208,17 @@ uint32_t cpt;
 static void driver_delay (uint32_t ms, void (*callback)(void))
 {
     if((delay.ms = ms) > 0) {
-        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
         if(!(delay.callback = callback))
             while(delay.ms);
     } else if(callback)
         callback();
 }
 
+static uint32_t getElapsedTicks (void)
+{
+    return elapsed_ticks;
+}
+
 // Enable/disable stepper motors
 static void stepperEnable (axes_signals_t enable)
 {
@@ -1014,7 +1019,7 @@ bool driver_init (void) {
 
     // Enable and set SysTick IRQ to lowest priority
     SysTick->LOAD = (SystemCoreClock / 1000) - 1;
-    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk;
+    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk|SysTick_CTRL_ENABLE_Msk;
     NVIC_SetPriority(SysTick_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
 
 #if EEPROM_ENABLE
@@ -1027,6 +1032,7 @@ bool driver_init (void) {
     hal.f_step_timer = SystemCoreClock / Chip_Clock_GetPCLKDiv(STEPPER_TIMER_PCLK);
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = &driver_delay;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -1115,7 +1121,7 @@ bool driver_init (void) {
 
     // No need to move version check before init.
     // Compiler will fail any signature mismatch for existing entries.
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -1272,25 +1278,20 @@ void GPIO_IRQHandler (void)
 // Interrupt handler for 1 ms interval timer
 void SysTick_Handler (void)
 {
+    elapsed_ticks++;
+
 #if SDCARD_ENABLE
     static uint32_t fatfs_ticks = 10;
     if(!(--fatfs_ticks)) {
         disk_timerproc();
         fatfs_ticks = 10;
     }
+#endif
+
     if(delay.ms && !(--delay.ms)) {
         if(delay.callback) {
             delay.callback();
             delay.callback = NULL;
         }
     }
-#else
-    if(!(--delay.ms)) {
-        SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
-        if(delay.callback) {
-            delay.callback();
-            delay.callback = NULL;
-        }
-    }
-#endif
 }
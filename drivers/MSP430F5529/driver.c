@@ -36,6 +36,7 @@ static axes_signals_t next_step_outbits;
 static spindle_pwm_t spindle_pwm;
 static uint16_t step_pulse_ticks;
 static delay_t delay = { .ms = 0, .callback = NULL };
+static volatile uint32_t elapsed_ticks = 0;
 
 static void spindle_set_speed (uint_fast16_t pwm_value);
 
@@ -44,15 +45,18 @@ static uint8_t probe_invert;
 
 static void driver_delay_ms (uint32_t ms, void (*callback)(void))
 {
-    if((delay.ms = ms > 0)) {
-        SYSTICK_TIMER_CCR0 = ms;
-        SYSTICK_TIMER_CTL |= TACLR|MC0;
+    if((delay.ms = ms) > 0) {
         if(!(delay.callback = callback))
             while(delay.ms);
     } else if(callback)
         callback();
 }
 
+static uint32_t getElapsedTicks (void)
+{
+    return elapsed_ticks;
+}
+
 // Set stepper pulse output pins
 // NOTE: step_outbits are: bit0 -> X, bit1 -> Y, bit2 -> Z, needs to be mapped to physical pins by bit shifting or other means
 inline static void set_step_outputs (axes_signals_t step_outbits)
@@ -632,12 +636,12 @@ static bool driver_setup (settings_t *settings)
 // NOTE: Grbl is not yet configured (from EEPROM data), driver_setup() will be called when done
 bool driver_init (void)
 {
-    // Systick timer setup, uses ACLK / 32
+    // Systick timer setup, uses ACLK / 16 in up mode with a period of 2 counts for a ~1mS interrupt rate
 
-    SYSTICK_TIMER_EX0 |= TAIDEX_3;
-    SYSTICK_TIMER_CTL |= TACLR|ID0|ID1|TASSEL__ACLK; // for 1mS per count
+    SYSTICK_TIMER_EX0 |= TAIDEX_1;
     SYSTICK_TIMER_CCR0 = 1;
     SYSTICK_TIMER_CCTL0 |= CCIE;
+    SYSTICK_TIMER_CTL |= TACLR|ID0|ID1|TASSEL__ACLK|MC0;
 
     serialInit();
 
@@ -647,6 +651,7 @@ bool driver_init (void)
     hal.f_step_timer = 24000000;
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -722,7 +727,7 @@ bool driver_init (void)
     __bis_SR_register(GIE); // Enable interrupts
 
     // no need to move version check before init - compiler will fail any signature mismatch for existing entries
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -812,10 +817,12 @@ __interrupt void limit_isr (void)
 #pragma vector=SYSTICK_TIMER0_VECTOR
 __interrupt void systick_isr (void)
 {
-    delay.ms = 0;
-    SYSTICK_TIMER_CTL &= ~(MC0|MC1);
-    if(delay.callback) {
-        delay.callback();
-        delay.callback = NULL;
+    elapsed_ticks++;
+
+    if(delay.ms && !(--delay.ms)) {
+        if(delay.callback) {
+            delay.callback();
+            delay.callback = NULL;
+        }
     }
 }
@@ -103,6 +103,7 @@ static volatile bool spindleLock = false;
 static bool pwmEnabled = false, IOInitDone = false;
 // Inverts the probe pin state depending on user settings and probing cycle mode.
 static bool probe_invert;
+static volatile bool limits_homing = false;
 static axes_signals_t next_step_outbits;
 static spindle_pwm_t spindle_pwm;
 static spindle_data_t spindle_data;
@@ -112,6 +113,7 @@ static spindle_sync_t spindle_tracker;
 static spindle_control_t spindle_control = { .pid_state = PIDState_Disabled, .pid = {0}};
 #endif
 static delay_t delay = { .ms = 1, .callback = NULL }; // NOTE: initial ms set to 1 for "resetting" systick timer on startup
+static volatile uint32_t elapsed_ticks = 0;
 
 static void stepperPulseStartSynchronized (stepper_t *stepper);
 static void spindle_set_speed (uint_fast16_t pwm_value);
@@ -216,13 +218,17 @@ inline static float pid (pid_t *pid, float command, float actual, float sample_r
 static void driver_delay_ms (uint32_t ms, void (*callback)(void))
 {
     if((delay.ms = ms) > 0) {
-        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
         if(!(delay.callback = callback))
             while(delay.ms);
     } else if(callback)
         callback();
 }
 
+static uint32_t getElapsedTicks (void)
+{
+    return elapsed_ticks;
+}
+
 // Set stepper pulse output pins
 // NOTE: step_outbits are: bit0 -> X, bit1 -> Y, bit2 -> Z...
 // Mapping to registers can be done by
@@ -423,8 +429,10 @@ static void stepperPulseStartSynchronized (stepper_t *stepper)
 }
 
 // Enable/disable limit pins interrupt
+// NOTE: enabled for homing regardless of the hard limits setting, used for latching the switch positions.
 static void limitsEnable (bool on, bool homing) {
-    on = on && settings.limits.flags.hard_enabled;
+    limits_homing = on && homing;
+    on = on && (homing || settings.limits.flags.hard_enabled);
 #if CNC_BOOSTERPACK_SHORTS
   #if STEP_OUTMODE == GPIO_BITBAND
     BITBAND_PERI(LIMIT_PORT->IFG, X_LIMIT_PIN) = 0;
@@ -643,8 +651,6 @@ static void spindleSetStateVariable (spindle_state_t state, float rpm)
         spindle_set_speed(spindle_pwm.off_value);
         spindle_off();
 #ifdef SPINDLE_RPM_CONTROLLED
-        if(delay.ms == 0)
-            SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
         spindle_encoder.rpm = 0.0f;
         spindle_control.pid_state = PIDState_Disabled;
         spindle_control.pid.error = 0.0f;
@@ -659,7 +665,6 @@ static void spindleSetStateVariable (spindle_state_t state, float rpm)
             if(spindle_control.pid.enabled) {
                 pid_count = 0;
                 spindle_control.pid_state = PIDState_Pending;
-                SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
             }
         }
   #ifdef sPID_LOG
@@ -936,7 +941,6 @@ void settings_changed (settings_t *settings)
             spindle_set_state((spindle_state_t){0}, 0.0f);
             memcpy(&spindle_control.pid.cfg, &settings->spindle.pid, sizeof(pid_values_t));
       //      spindle_encoder.pid.cfg.i_max_error = spindle_encoder.pid.cfg.i_max_error / settings->spindle.pid.i_gain; // Makes max value sensible?
-            SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
         }
     } else
         spindle_control.pid_state = PIDState_Disabled;
@@ -1378,7 +1382,7 @@ bool driver_init (void)
 
     SysTick->LOAD = (SystemCoreClock / 1000) - 1;
     SysTick->VAL = 0;
-    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk;
+    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk|SysTick_CTRL_ENABLE_Msk;
 
 #if MPG_MODE_ENABLE
     // Drive MPG mode input pin low until setup complete
@@ -1398,6 +1402,7 @@ bool driver_init (void)
     hal.f_step_timer = SystemCoreClock;
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -1493,13 +1498,14 @@ bool driver_init (void)
     hal.driver_cap.amass_level = 3;
     hal.driver_cap.control_pull_up = On;
     hal.driver_cap.limits_pull_up = On;
+    hal.driver_cap.limits_homing_irq = On;
     hal.driver_cap.probe_pull_up = On;
 #if MPG_MODE_ENABLE
     hal.driver_cap.mpg_mode = On;
 #endif
 
     // no need to move version check before init - compiler will fail any signature mismatch for existing entries
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -1598,7 +1604,7 @@ void LIMIT_IRQHandler (void)
     LIMIT_PORT->IFG &= ~iflags;
 
     if(iflags & LIMIT_MASK) {
-        if(hal.driver_cap.software_debounce)
+        if(hal.driver_cap.software_debounce && !limits_homing) // No debounce when homing, the first edge is latched.
             DEBOUNCE_TIMER->CTL |= TIMER_A_CTL_CLR|TIMER_A_CTL_MC0;
         else
             hal.limit_interrupt_callback(limitsGetState());
@@ -1629,7 +1635,7 @@ void LIMIT_X_IRQHandler (void)
     LIMIT_PORT_X->IFG = 0;
 
     if(iflags & LIMIT_MASK_X) {
-        if(hal.driver_cap.software_debounce)
+        if(hal.driver_cap.software_debounce && !limits_homing) // No debounce when homing, the first edge is latched.
             DEBOUNCE_TIMER->CTL |= TIMER_A_CTL_CLR|TIMER_A_CTL_MC0;
         else
             hal.limit_interrupt_callback(limitsGetState());
@@ -1644,7 +1650,7 @@ void LIMIT_YZ_RST_IRQHandler (void)
     LIMIT_PORT_Y->IFG = 0;
 
     if(iflags & LIMIT_MASK_YZ) {
-        if(hal.driver_cap.software_debounce)
+        if(hal.driver_cap.software_debounce && !limits_homing) // No debounce when homing, the first edge is latched.
             DEBOUNCE_TIMER->CTL |= TIMER_A_CTL_CLR|TIMER_A_CTL_MC0;
         else
             hal.limit_interrupt_callback(limitsGetState());
@@ -1732,6 +1738,7 @@ void TRINAMIC_DIAG_IRQHandler (void)
 // Interrupt handler for 1 ms interval timer
 void SysTick_Handler (void)
 {
+    elapsed_ticks++;
 
 #ifdef SPINDLE_RPM_CONTROLLED
 
@@ -1769,24 +1776,12 @@ void SysTick_Handler (void)
             break;
     }
 
-    if(delay.ms && !(--delay.ms)) {
-        if(spindle_control.pid_state == PIDState_Disabled)
-            SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
-        if(delay.callback) {
-            delay.callback();
-            delay.callback = NULL;
-        }
-    }
-
-#else
+#endif
 
-    if(!(--delay.ms)) {
-        SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    if(delay.ms && !(--delay.ms)) {
         if(delay.callback) {
             delay.callback();
             delay.callback = NULL;
         }
     }
-
-#endif
 }
@@ -241,6 +241,9 @@ static bool pwmEnabled = false, IOInitDone = false;
 static axes_signals_t next_step_outbits;
 static spindle_pwm_t spindle_pwm;
 static delay_t delay = { .ms = 1, .callback = NULL }; // NOTE: initial ms set to 1 for "resetting" systick timer on startup
+#ifndef FreeRTOS
+static volatile uint32_t elapsed_ticks = 0;
+#endif
 
 // Inverts the probe pin state depending on user settings and probing cycle mode.
 static uint8_t probe_invert;
@@ -405,7 +408,6 @@ static void driver_delay_ms (uint32_t ms, void (*callback)(void))
 {
     if(ms) {
         delay.ms = ms;
-        SysTickEnable();
         if(!(delay.callback = callback))
             while(delay.ms);
     } else {
@@ -419,6 +421,16 @@ static void driver_delay_ms (uint32_t ms, void (*callback)(void))
 }
 #endif
 
+// Returns milliseconds elapsed since startup.
+static uint32_t getElapsedTicks (void)
+{
+#ifdef FreeRTOS
+    return xTaskGetTickCount() * portTICK_PERIOD_MS;
+#else
+    return elapsed_ticks;
+#endif
+}
+
 // Set stepper pulse output pins
 // NOTE: step_outbits are: bit0 -> X, bit1 -> Y, bit2 -> Z...
 // Mapping to registers can be done by
@@ -1753,6 +1765,7 @@ bool driver_init (void)
 #endif
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -1875,7 +1888,7 @@ bool driver_init (void)
 #endif
 
     // no need to move version check before init - compiler will fail any signature mismatch for existing entries
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -2197,6 +2210,8 @@ static void control_isr_sd (void)
 #if PWM_RAMPED
 static void systick_isr (void)
 {
+    elapsed_ticks++;
+
     if(pwm_ramp.ms_cfg) {
         if(++pwm_ramp.delay.ms == pwm_ramp.ms_cfg) {
 
@@ -2232,15 +2247,13 @@ static void systick_isr (void)
         delay.callback();
         delay.callback = 0;
     }
-
-    if(!(delay.ms || pwm_ramp.ms_cfg))
-        SysTickDisable();
 }
 #else
 static void systick_isr (void)
 {
-    if(!(--delay.ms)) {
-        SysTickDisable();
+    elapsed_ticks++;
+
+    if(delay.ms && !(--delay.ms)) {
         if(delay.callback) {
             delay.callback();
             delay.callback = NULL;
@@ -37,6 +37,7 @@ static bool spindlePWM = false, IOInitDone = false;
 static spindle_pwm_t spindle_pwm;
 static axes_signals_t next_step_outbits;
 static delay_t delay = { .ms = 1, .callback = NULL }; // NOTE: initial ms set to 1 for "resetting" systick timer on startup
+static volatile uint32_t elapsed_ticks = 0;
 
 // Interrupt handler prototypes
 static void stepper_driver_isr (void);
@@ -55,6 +56,11 @@ static void driver_delay_ms (uint32_t ms, void (*callback)(void))
         callback();
 }
 
+static uint32_t getElapsedTicks (void)
+{
+    return elapsed_ticks;
+}
+
 // Non-variable spindle
 
 // Start or stop spindle, called from spindle_run() and protocol_execute_realtime()
@@ -409,6 +415,7 @@ bool driver_init (void)
     hal.f_step_timer = 24000000UL;
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -475,7 +482,7 @@ bool driver_init (void)
 
     // No need to move version check before init.
     // Compiler will fail any signature mismatch for existing entries.
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -513,8 +520,10 @@ static void control_isr (void)
 static void systick_isr (void)
 {
     DelayTimer_ReadStatusRegister();
-    if(!(--delay.ms)) {
-        DelayTimer_Stop();
+
+    elapsed_ticks++;
+
+    if(delay.ms && !(--delay.ms)) {
         if(delay.callback) {
             delay.callback();
             delay.callback = NULL;
@@ -110,6 +110,7 @@ static bool probe_invert;
 static axes_signals_t next_step_outbits;
 static spindle_pwm_t spindle_pwm;
 static delay_t delay_ms = { .ms = 1, .callback = NULL }; // NOTE: initial ms set to 1 for "resetting" systick timer on startup
+static volatile uint32_t elapsed_ticks = 0;
 static debounce_queue_t debounce_queue = {0};
 static input_signal_t a_signals[10] = {0}, b_signals[10] = {0}, c_signals[10] = {0}, d_signals[10] = {0};
 #ifdef SQUARING_ENABLED
@@ -200,13 +201,17 @@ void IRQUnRegister(int32_t IRQnum)
 static void driver_delay_ms (uint32_t ms, void (*callback)(void))
 {
     if((delay_ms.ms = ms) > 0) {
-        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
         if(!(delay_ms.callback = callback))
             while(delay_ms.ms);
     } else if(callback)
         callback();
 }
 
+static uint32_t getElapsedTicks (void)
+{
+    return elapsed_ticks;
+}
+
 // Set stepper pulse output pins
 #ifdef SQUARING_ENABLED
 inline static void set_step_outputs (axes_signals_t step_outbits_1)
@@ -1472,7 +1477,7 @@ bool driver_init (void)
 
     SysTick->LOAD = (SystemCoreClock / 1000) - 1;
     SysTick->VAL = 0;
-    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk;
+    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk|SysTick_CTRL_ENABLE_Msk;
 
     IRQRegister(SysTick_IRQn, SysTick_IRQHandler);
 
@@ -1485,6 +1490,7 @@ bool driver_init (void)
     hal.f_step_timer = SystemCoreClock / 2; // 42 MHz
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -1628,7 +1634,7 @@ bool driver_init (void)
 
     // No need to move version check before init.
     // Compiler will fail any signature mismatch for existing entries.
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -1762,8 +1768,7 @@ static void PIOD_IRQHandler (void)
 // Interrupt handler for 1 ms interval timer
 static void SysTick_IRQHandler (void)
 {
-
-#if USB_SERIAL || SDCARD_ENABLE
+    elapsed_ticks++;
 
 #if USB_SERIAL
     SysTick_Handler(); // SerialUSB needs the Arduino SysTick handler running
@@ -1783,13 +1788,4 @@ static void SysTick_IRQHandler (void)
             delay_ms.callback = NULL;
         }
     }
-#else
-    if(!(--delay_ms.ms)) {
-        SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
-        if(delay_ms.callback) {
-            delay_ms.callback();
-            delay_ms.callback = NULL;
-        }
-    }
-#endif
 }
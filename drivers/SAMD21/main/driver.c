@@ -60,6 +60,7 @@ static bool probe_invert, sd_detect = false;
 static axes_signals_t next_step_outbits;
 static spindle_pwm_t spindle_pwm;
 static delay_t delay_ms = { .ms = 1, .callback = NULL }; // NOTE: initial ms set to 1 for "resetting" systick timer on startup
+static volatile uint32_t elapsed_ticks = 0;
 
 static axes_signals_t limit_ies; // declare here for now...
 
@@ -96,13 +97,17 @@ void IRQUnRegister(int32_t IRQnum)
 static void driver_delay_ms (uint32_t ms, void (*callback)(void))
 {
     if((delay_ms.ms = ms) > 0) {
-        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
         if(!(delay_ms.callback = callback))
             while(delay_ms.ms);
     } else if(callback)
         callback();
 }
 
+static uint32_t getElapsedTicks (void)
+{
+    return elapsed_ticks;
+}
+
 // Set stepper pulse output pins
 inline static void set_step_outputs (axes_signals_t step_outbits)
 {
@@ -1000,7 +1005,7 @@ bool driver_init (void) {
 
     SysTick->LOAD = (SystemCoreClock / 1000) - 1;
     SysTick->VAL = 0;
-    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk;
+    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk|SysTick_CTRL_ENABLE_Msk;
     NVIC_SetPriority(SysTick_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
 
     IRQRegister(SysTick_IRQn, SysTick_IRQHandler);
@@ -1011,6 +1016,7 @@ bool driver_init (void) {
     hal.f_step_timer = SystemCoreClock / 3;
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -1133,7 +1139,7 @@ bool driver_init (void) {
 
     // No need to move version check before init.
     // Compiler will fail any signature mismatch for existing entries.
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -1214,12 +1220,15 @@ void KEYPAD_IRQHandler (void)
 // Interrupt handler for 1 ms interval timer
 static void SysTick_IRQHandler (void)
 {
+    elapsed_ticks++;
+
 #if SDCARD_ENABLE
     static uint32_t fatfs_ticks = 10;
     if(!(--fatfs_ticks)) {
         disk_timerproc();
         fatfs_ticks = 10;
     }
+#endif
 
     if(delay_ms.ms && !(--delay_ms.ms)) {
         if(delay_ms.callback) {
@@ -1227,13 +1236,4 @@ static void SysTick_IRQHandler (void)
             delay_ms.callback = NULL;
         }
     }
-#else
-    if(!(--delay_ms.ms)) {
-        SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
-        if(delay_ms.callback) {
-            delay_ms.callback();
-            delay_ms.callback = NULL;
-        }
-    }
-#endif
 }
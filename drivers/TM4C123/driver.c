@@ -106,6 +106,7 @@ static bool pwmEnabled = false, IOInitDone = false, probeState = false;
 static axes_signals_t next_step_outbits;
 static spindle_pwm_t spindle_pwm;
 static delay_t delay = { .ms = 1, .callback = NULL }; // NOTE: initial ms set to 1 for "resetting" systick timer on startup
+static volatile uint32_t elapsed_ticks = 0;
 
 // Inverts the probe pin state depending on user settings and probing cycle mode.
 static uint8_t probe_invert;
@@ -164,7 +165,6 @@ static void driver_delay_ms (uint32_t ms, void (*callback)(void))
 
     if(ms) {
         delay.ms = ms;
-        SysTickEnable();
         if(!(delay.callback = callback))
             while(delay.ms);
     } else {
@@ -177,6 +177,11 @@ static void driver_delay_ms (uint32_t ms, void (*callback)(void))
     }
 }
 
+static uint32_t getElapsedTicks (void)
+{
+    return elapsed_ticks;
+}
+
 // Set stepper pulse output pins
 // NOTE: step_outbits are: bit0 -> X, bit1 -> Y, bit2 -> Z...
 // Mapping to registers can be done by
@@ -1138,6 +1143,7 @@ bool driver_init (void)
     hal.f_step_timer = SysCtlClockGet() / (STEPPER_DRIVER_PRESCALER + 1); // 20 MHz
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -1256,7 +1262,7 @@ bool driver_init (void)
 
     // No need to move version check before init.
     // Compiler will fail any signature mismatch for existing entries.
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -1403,6 +1409,8 @@ static void trinamic_diag1_isr (void)
 #if PWM_RAMPED
 static void systick_isr (void)
 {
+    elapsed_ticks++;
+
     if(pwm_ramp.ms_cfg) {
         if(++pwm_ramp.delay.ms == pwm_ramp.ms_cfg) {
 
@@ -1438,15 +1446,13 @@ static void systick_isr (void)
         delay.callback();
         delay.callback = 0;
     }
-
-    if(!(delay.ms || pwm_ramp.ms_cfg))
-        SysTickDisable();
 }
 #else
 static void systick_isr (void)
 {
-    if(!(--delay.ms)) {
-        SysTickDisable();
+    elapsed_ticks++;
+
+    if(delay.ms && !(--delay.ms)) {
         if(delay.callback) {
             delay.callback();
             delay.callback = NULL;
@@ -198,6 +198,17 @@
 #define SAFETY_DOOR_SPINDLE_DELAY 4.0f // Float (seconds)
 #define SAFETY_DOOR_COOLANT_DELAY 1.0f // Float (seconds)
 
+// Enable to hide spindle spin-up time behind positioning moves. When the spindle is started or its speed
+// changed the g-code parser does not wait for it to get up to speed, rapid (G0) motions following are
+// executed while it spins up. The first feed motion is held back until the spindle is at speed, or for
+// spindles without at speed feedback until SPINDLE_SPINUP_TIME has elapsed. Not used in laser mode.
+// Spin-up time is measured from spindle start, an alarm is raised if a spindle with at speed feedback
+// does not get up to speed within SAFETY_DOOR_SPINDLE_DELAY.
+// NOTE: Requires the driver to provide the HAL get_elapsed_ticks entry point, else the parser waits as usual.
+// NOTE: Spindle drivers that delay when started should not be used with this option.
+//#define SPINDLE_SPINUP_OVERLAP // Default disabled. Uncomment to enable.
+#define SPINDLE_SPINUP_TIME 0.0f // Float (seconds)
+
 // ---------------------------------------------------------------------------------------
 // ADVANCED CONFIGURATION OPTIONS:
 
@@ -256,6 +267,15 @@
 // certain the step segment buffer is increased/decreased to account for these changes.
 #define ACCELERATION_TICKS_PER_SECOND 100
 
+// Adaptive segment duration. When enabled segments generated while cruising at constant speed are
+// generated at this lower rate, resulting in longer segments. This reduces the foreground CPU load of
+// the segment generator and increases the motion time stored in the segment buffer. Acceleration and
+// deceleration ramps, spindle synchronized motion, motion with continuously updated laser power and feed
+// holds are still segmented at ACCELERATION_TICKS_PER_SECOND.
+// NOTE: Longer segments increases the latency of feed holds and overrides since already generated
+// segments are executed before the change takes effect. Must be less than ACCELERATION_TICKS_PER_SECOND.
+//#define SEGMENT_CRUISE_TICKS_PER_SECOND 50 // Default disabled. Uncomment to enable.
+
 // Adaptive Multi-Axis Step Smoothing (AMASS) is an advanced feature that does what its name implies,
 // smoothing the stepping of multi-axis motions. This feature smooths motion particularly at low step
 // frequencies below 10kHz, where the aliasing between axes of multi-axis motions can cause audible
@@ -263,6 +283,55 @@
 // step smoothing. See stepper.c for more details on the AMASS system works.
 #define ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING  // Default enabled. Comment to disable.
 
+// Replaces the Bresenham line tracer with AMASS by a per axis digital differential analyzer (DDA). Each
+// segment carries a fractional phase increment per axis so that every axis steps at its own exact rate,
+// and the stepper ISR ticks at the dominant axis step rate but never slower than STEP_DDA_TICK_RATE.
+// Compared to AMASS this lowers the ISR rate at low step frequencies, where AMASS overdrives the timer
+// up to 8x, while still spreading the steps of non-dominant axes evenly. Set STEP_DDA_TICK_RATE to at
+// least the maximum step rate of the machine to run the ISR from a single fixed frequency tick.
+// NOTE: Disables ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING. Use doc/script/step_generator.py to compare the
+// step timing of the two algorithms.
+//#define STEP_GENERATOR_DDA // Default disabled. Uncomment to enable.
+#define STEP_DDA_TICK_RATE 4000 // Hz, minimum DDA tick rate.
+
+#if defined(STEP_GENERATOR_DDA) && defined(ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING)
+  #undef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+#endif
+
+// Enables stepper ISRs specialized for the number of axes moved by the block and for probing. These are
+// selected by the stepper ISR when a segment is loaded and execute the remaining ticks of the segment with
+// only the axes moved traced, e.g. X and Y for most 2.5D motions. Homing, backlash take-up, laser raster
+// and laser power ramping run the generic ISR. Raises the maximum step rate on slower processors.
+// NOTE: Swaps hal.stepper_interrupt_callback, drivers must call it via the HAL pointer.
+//#define SPECIALIZED_STEPPER_ISR // Default disabled. Uncomment to enable.
+
+// Binds the step pulse output and step timer reload of the driver to the stepper ISR at compile time,
+// replacing the calls via hal.stepper_pulse_start and hal.stepper_cycles_per_tick. The driver must
+// provide a header, named by this symbol, defining the inline functions:
+//   static inline void driver_stepper_pulse_start (stepper_t *stepper);
+//   static inline void driver_stepper_cycles_per_tick (uint32_t cycles_per_tick);
+// See templates/arm-driver/stepper_inline.h for an example.
+// NOTE: Plugins chaining hal.stepper_pulse_start are bypassed, plugins must subscribe to hooks.step_pulse instead.
+//#define HAL_STEPPER_INLINE "stepper_inline.h" // Default disabled. Uncomment to enable.
+
+// Sets and clears the realtime execution flags, sys_rt_exec_state and sys_rt_exec_alarm, with lock-free
+// atomic read-modify-write instructions instead of via hal.set_bits_atomic and friends, which drivers
+// implement by disabling interrupts. Compiles to LDREX/STREX loops on Cortex-M3 and later and to native
+// atomics on other processors. Processors without lock-free atomics, e.g. Cortex-M0 and MSP430, use the
+// HAL functions regardless of this setting.
+#define RT_FLAGS_LOCK_FREE // Default enabled. Comment to disable.
+
+// Runs step segment preparation from a low priority interrupt, requested by the stepper ISR when the
+// segment buffer drops to SEGMENT_PREP_THRESHOLD segments. The interrupt must be preempted by the stepper
+// ISR and preempt the foreground, step continuity then no longer depends on slow foreground code such as
+// blocking stream output, file systems or I2C EEPROM writes. The foreground still prepares segments at
+// its realtime check points, with the interrupt locked out while it modifies the planner or sys.step_control.
+// Memory of completed planner blocks and scanlines is freed by the foreground, not by the interrupt.
+// The driver must provide hal.stepper_prep_request, pending an interrupt that calls hal.stepper_prep_callback,
+// e.g. PendSV or an unused NVIC interrupt on ARM processors. Without it segments are prepared by the
+// foreground only.
+//#define SEGMENT_PREP_IRQ // Default disabled. Uncomment to enable.
+
 // Define Adaptive Multi-Axis Step-Smoothing(AMASS) levels and cutoff frequencies. The highest level
 // frequency bin starts at 0Hz and ends at its cutoff frequency. The next lower level frequency bin
 // starts at the next higher cutoff frequency, and so on. The cutoff frequencies for each level must
@@ -309,6 +378,22 @@
 // machines, perhaps to 0.1mm/min, but your success may vary based on multiple factors.
 #define MINIMUM_FEED_RATE 1.0f // (mm/min)
 
+// Starvation aware feed limiting. When the input stream cannot deliver blocks as fast as they are executed
+// the planner will plan to a complete stop at the end of the buffer over and over again, resulting in
+// stop-start motion that ruins surface finish. With this enabled the nominal speed of new blocks is
+// capped while in a cycle so that the motion buffered in the planner does not drain faster than the
+// set time horizon, trading a slightly lower feed rate for continuous motion. The cap is based on the
+// distance buffered and, if the driver provides the HAL get_elapsed_ticks entry point, the measured
+// rate at which motion is delivered by the input stream. Spindle synchronized, inverse time and jog
+// motions are not limited. The value is the time horizon in milliseconds.
+//#define PLANNER_TIME_HORIZON 100 // Default disabled. Uncomment to enable.
+
+// Continuous (velocity mode) jogging, used by keypads and MPGs, queues motion as short blocks of this
+// duration and only so far ahead as needed to reach and hold the requested speed. The machine then stops
+// within the deceleration distance plus one block when the key or handwheel is released.
+// The value is the block time in milliseconds.
+#define JOG_CONTINUOUS_BLOCK_TIME 50.0f
+
 // Number of arc generation iterations by small angle approximation before exact arc trajectory
 // correction with expensive sin() and cos() calculations. This parameter maybe decreased if there
 // are issues with the accuracy of the arc generations, or increased if arc execution is getting
@@ -326,7 +411,8 @@
 #define ARC_ANGULAR_TRAVEL_EPSILON 5E-7f // Float (radians)
 
 // Default constants for G5 Cubic splines
-//
+// BEZIER_MIN_STEP and BEZIER_MAX_STEP limits the curve parameter step size (0 - 1) between segments,
+// BEZIER_SIGMA is the maximum allowed chord error (mm) of a segment.
 #define BEZIER_MIN_STEP 0.002f
 #define BEZIER_MAX_STEP 0.1f
 #define BEZIER_SIGMA 0.1f
@@ -357,6 +443,38 @@
 // the position to the probe target, when enabled sets the position to the start position.
 // #define SET_CHECK_MODE_PROBE_TO_START // Default disabled. Uncomment to enable.
 
+// Enables probing sequences executed in firmware, without host round trips between the stages. A G38.x
+// command with a Q word first probes at the F feed rate, then backs off by the R distance and probes again
+// at the Q feed rate. With an L word the latch probe is repeated L times and the probe positions averaged.
+// R defaults to PROBE_SEQUENCE_RETRACT (mm) when not given. Latch probes travel at most R beyond the
+// position found by the seek probe.
+//#define PROBE_SEQUENCE // Default disabled. Uncomment to enable.
+#define PROBE_SEQUENCE_RETRACT 2.0f // mm
+
+// Enables Z compensation from a probed height map, for milling and engraving warped stock such as PCBs.
+// $ZP=<X length>,<Y length>,<X points>,<Y points>,<probe depth>,<clearance>,<feed rate> probes a grid
+// starting at the current position, $Z reports the map and $Z0/$Z1 disables/enables compensation.
+// Line motions are split at grid cell boundaries and Z is offset by bilinear interpolation of the
+// probed heights relative to the first point. The map is kept in RAM and is lost on power down.
+//#define HEIGHT_MAP_COMPENSATION // Default disabled. Uncomment to enable.
+#define HEIGHT_MAP_MAX_POINTS 16 // Max number of grid points per axis.
+
+// Enables laser raster scanlines where each scanline is executed as a single line motion and the stepper
+// ISR sets the laser power per pixel, instead of one G1 motion per pixel with power changes only at step
+// segment boundaries. $L=<X direction>,<Y direction>,<pixel pitch>:<pixels> engraves a scanline from the
+// current position, pixels are base64 characters with 64 power levels from 0 (A) to the S value (/).
+// Requires laser mode and M3 or M4, feed rate is taken from the parser state. Add overscan moves for the
+// laser head to be at speed across the scanline since power is not scaled with speed.
+//#define LASER_RASTER_MODE // Default disabled. Uncomment to enable.
+
+// Enables laser power synchronized with the step rate for rate adjusted (M4) motions. Power is otherwise
+// computed once per step segment from the speed at the end of the segment and lags the velocity during
+// short acceleration and deceleration ramps. With this enabled the stepper ISR ramps the PWM value from the
+// power at the start to the power at the end of each segment, updating it every LASER_POWER_RATE_SYNC_TICKS
+// ISR ticks with a precomputed fixed point increment. Requires PWM spindle output (SPINDLE_PWM_DIRECT).
+//#define LASER_POWER_RATE_SYNC // Default disabled. Uncomment to enable.
+#define LASER_POWER_RATE_SYNC_TICKS 4 // ISR ticks between power updates (1-255).
+
 // Force Grbl to check the state of the hard limit switches when the processor detects a pin
 // change inside the hard limit ISR routine. By default, Grbl will trigger the hard limits
 // alarm upon any pin change, since bouncing switches can cause a state check like this to
@@ -377,6 +495,13 @@
 // #define HOMING_AXIS_SEARCH_SCALAR  1.5f // Uncomment to override defaults in limits.c.
 // #define HOMING_AXIS_LOCATE_SCALAR  10.0f // Uncomment to override defaults in limits.c.
 
+// Enables latching of the homing switch positions by the limit pin change interrupt, for drivers that
+// supports limit interrupts during homing (driver_cap.limits_homing_irq). The interrupt latches the
+// position and locks out the axis on the switch edge, instead of the homing cycle polling the switches
+// in the foreground loop. The final machine position is corrected for the overshoot past the trigger
+// point so repeatability no longer depends on the seek rate, allowing faster seeks.
+//#define ENABLE_HOMING_LIMIT_LATCH // Default disabled. Uncomment to enable.
+
 // Enable the '$RST=*', '$RST=$', and '$RST=#' eeprom restore commands. There are cases where
 // these commands may be undesirable. Simply comment the desired macro to disable it.
 // NOTE: See SETTINGS_RESTORE_ALL macro for customizing the `$RST=*` command.
@@ -406,6 +531,14 @@
 // NOTE: See the included grblWrite_BuildInfo.ino example file to write this string seperately.
 #define ENABLE_BUILD_INFO_WRITE_COMMAND // '$I=' Default enabled. Comment to disable.
 
+// Freezes the global settings for production builds of a tuned machine. The settings are taken from a
+// header generated from a `$$` dump with doc/script/freeze_settings.py, it overrides the defaults in
+// defaults.h. The settings structure is then a constant in flash, not read from or written to EEPROM,
+// and the planner uses compile time per axis constants (e.g. reciprocal steps/mm) in its hot path.
+// NOTE: `$x=` is rejected with error 5 for global settings, driver settings can still be changed.
+//       `$RST=$` does not restore the global settings. Masks are not checked against driver capabilities.
+//#define SETTINGS_FROZEN "settings_frozen.h" // Default disabled. Uncomment to enable.
+
 // In Grbl v0.9 and prior, there is an old outstanding bug where the `WPos:` work position reported
 // may not correlate to what is executing, because `WPos:` is based on the g-code parser state, which
 // can be several motions behind. This option forces the planner buffer to empty, sync, and stop
@@ -433,6 +566,33 @@
 // Max number of entries in log for PID data reporting, to be used for tuning
 //#define PID_LOG 1000 // Default disabled. Uncomment to enable.
 
-//#define ENABLE_BACKLASH_COMPENSATION
+// Enables segment buffer underrun and planner starvation counters, used to determine if motion stutter
+// is caused by the input stream, the parser or the planner not keeping up with the stepper ISR.
+// Statistics are reported by the $ST command ($STR reports and resets), a |St: element is added
+// to the real time report when the underrun or planner empty counters changes.
+// Underruns are counted separately for segment preparation not keeping up and for the planner having
+// run empty (input stream or parser not keeping up) before the segment buffer ran empty.
+// NOTE: Timestamps requires the driver to provide the optional HAL get_elapsed_ticks entry point.
+//#define ENABLE_STEPPER_TELEMETRY // Default disabled. Uncomment to enable.
+
+// Enables backlash compensation, configured per axis by the $16x settings. On a direction reversal the
+// stepper ISR takes up the backlash by extra steps, not added to the machine position, interleaved with
+// the steps of the new block. No extra planner blocks are inserted so reversals do not force the planner
+// to slow down. When the reversing axis is stepped on every ISR tick the motion is held back by one tick
+// per backlash step.
+//#define ENABLE_BACKLASH_COMPENSATION // Default disabled. Uncomment to enable.
+
+// Enables input shaping for suppression of frame vibrations, allowing higher acceleration settings.
+// Shapers are configured per axis by the $21x (frequency, Hz), $22x (damping ratio) and $23x (type,
+// 0 = ZV, 1 = ZVD, 2 = EI) settings, a frequency of 0 disables the shaper for the axis. The shapers of
+// different axes are combined and applied to the path motion: the segment generator retimes the step
+// segments to follow the path distance over time convolved with the shaper impulses. Segments are held
+// back from the stepper ISR for up to the shaper duration (ZV: half, ZVD and EI: a full vibration period)
+// so the segment buffer must be large enough to hold that plus some margin, increase SEGMENT_BUFFER_SIZE
+// for low frequencies. Spindle synchronized and homing motions are not shaped.
+// doc/script/input_shaper.py simulates the residual vibration for a given shaper.
+//#define INPUT_SHAPING // Default disabled. Uncomment to enable.
+#define INPUT_SHAPER_MAX_IMPULSES 9 // Max impulses of the combined shaper, 9 allows two different axis shapers.
+#define INPUT_SHAPER_EI_VTOL 0.05f // Residual vibration tolerance of the EI shaper (5%).
 
 #endif
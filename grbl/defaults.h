@@ -336,4 +336,10 @@
 #define INVERT_COOLANT_MIST_PIN 0
 #endif
 
+// Frozen settings, overrides the defaults above. See SETTINGS_FROZEN in config.h.
+
+#ifdef SETTINGS_FROZEN
+#include SETTINGS_FROZEN
+#endif
+
 #endif
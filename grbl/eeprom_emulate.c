@@ -225,11 +225,13 @@ void eeprom_emu_sync_physical ()
         if(settings_dirty.build_info) {
             settings_dirty.build_info = false;
             physical_eeprom.memcpy_to_with_checksum(EEPROM_ADDR_BUILD_INFO, (uint8_t *)(noepromdata + EEPROM_ADDR_BUILD_INFO), MAX_STORED_LINE_LENGTH);
+            task_yield();
         }
 
         if(settings_dirty.global_settings) {
             settings_dirty.global_settings = false;
             physical_eeprom.memcpy_to_with_checksum(EEPROM_ADDR_GLOBAL, (uint8_t *)(noepromdata + EEPROM_ADDR_GLOBAL), sizeof(settings_t));
+            task_yield();
         }
 
         uint_fast8_t idx = N_STARTUP_LINE, offset;
@@ -239,6 +241,7 @@ void eeprom_emu_sync_physical ()
                 bit_false(settings_dirty.startup_lines, bit(idx));
                 offset = EEPROM_ADDR_STARTUP_BLOCK + idx * (MAX_STORED_LINE_LENGTH + 1);
                 physical_eeprom.memcpy_to_with_checksum(offset, (uint8_t *)(noepromdata + offset), MAX_STORED_LINE_LENGTH);
+                task_yield();
             }
         } while(idx);
 
@@ -248,6 +251,7 @@ void eeprom_emu_sync_physical ()
                 bit_false(settings_dirty.coord_data, bit(idx));
                 offset = EEPROM_ADDR_PARAMETERS + idx * (sizeof(coord_data_t) + 1);
                 physical_eeprom.memcpy_to_with_checksum(offset, (uint8_t *)(noepromdata + offset), sizeof(coord_data_t));
+                task_yield();
             }
         } while(idx--);
 
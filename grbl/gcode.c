@@ -1891,6 +1891,25 @@ status_code_t gc_execute_block(char *block, char *message)
                         FAIL(Status_GcodeNoAxisWords); // [No axis words]
                     if (isequal_position_vector(gc_state.position, gc_block.values.xyz))
                         FAIL(Status_GcodeInvalidTarget); // [Invalid target]
+                  #ifdef PROBE_SEQUENCE
+                    // Probing sequence: Q is the latch feed rate, R the retract distance and L the number of latch probes to average.
+                    if(bit_istrue(value_words, bit(Word_Q))) {
+                        if(gc_block.values.q <= 0.0f || (bit_istrue(value_words, bit(Word_R)) && gc_block.values.r <= 0.0f))
+                            FAIL(Status_NonPositiveValue);
+                        if(bit_istrue(value_words, bit(Word_L)) && gc_block.values.l == 0)
+                            FAIL(Status_GcodeValueOutOfRange);
+                        if(bit_isfalse(value_words, bit(Word_L)))
+                            gc_block.values.l = 1;
+                        if (gc_block.modal.units_imperial) {
+                            gc_block.values.q *= MM_PER_INCH;
+                            gc_block.values.r *= MM_PER_INCH;
+                        }
+                        if(bit_isfalse(value_words, bit(Word_R)))
+                            gc_block.values.r = PROBE_SEQUENCE_RETRACT;
+                        gc_parser_flags.probe_sequence = On;
+                        bit_false(value_words, bit(Word_L)|bit(Word_Q)|bit(Word_R));
+                    }
+                  #endif
                     break;
 
                 default:
@@ -2381,6 +2400,11 @@ status_code_t gc_execute_block(char *block, char *message)
                 // NOTE: gc_block.values.xyz is returned from mc_probe_cycle with the updated position value. So
                 // upon a successful probing cycle, the machine position and the returned value should be the same.
                 plan_data.condition.no_feed_override = !settings.flags.allow_probing_feed_override;
+              #ifdef PROBE_SEQUENCE
+                if(gc_parser_flags.probe_sequence)
+                    gc_update_pos = (pos_update_t)mc_probe_sequence(gc_block.values.xyz, &plan_data, gc_parser_flags, gc_block.values.q, gc_block.values.r, gc_block.values.l);
+                else
+              #endif
                 gc_update_pos = (pos_update_t)mc_probe_cycle(gc_block.values.xyz, &plan_data, gc_parser_flags);
                 break;
 
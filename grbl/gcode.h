@@ -79,6 +79,7 @@ typedef enum {
     Status_HomingRequired = 46,
     Status_GCodeToolError = 47,
     Status_ValueWordConflict = 48,
+    Status_ProbeFailed = 49,
 
     Status_EStop = 50,
     Status_Unhandled = 59, // For internal use only
@@ -341,7 +342,8 @@ typedef union {
                  laser_is_motion     :1,
                  set_coolant         :1,
                  motion_mode_changed :1,
-                 reserved            :6;
+                 probe_sequence      :1,
+                 reserved            :5;
     };
 } gc_parser_flags_t;
 
@@ -59,6 +59,10 @@
 #include "system.h"
 #include "override.h"
 #include "sleep.h"
+#include "task.h"
+#include "hooks.h"
+#include "heightmap.h"
+#include "raster.h"
 #include "stream.h"
 #ifdef KINEMATICS_API
 #include "kinematics.h"
@@ -91,6 +95,20 @@
 #if (REPORT_OVERRIDE_REFRESH_IDLE_COUNT < 1)
   #error "Override refresh must be greater than zero."
 #endif
+#if defined(SEGMENT_CRUISE_TICKS_PER_SECOND) && (SEGMENT_CRUISE_TICKS_PER_SECOND >= ACCELERATION_TICKS_PER_SECOND || SEGMENT_CRUISE_TICKS_PER_SECOND < 1)
+  #error "Segment cruise ticks per second must be less than acceleration ticks per second."
+#endif
+
+#if defined(LASER_POWER_RATE_SYNC) && !defined(SPINDLE_PWM_DIRECT)
+  #error "LASER_POWER_RATE_SYNC requires SPINDLE_PWM_DIRECT."
+#endif
+#if defined(LASER_POWER_RATE_SYNC) && (LASER_POWER_RATE_SYNC_TICKS < 1 || LASER_POWER_RATE_SYNC_TICKS > 255)
+  #error "Laser power rate sync ticks must be in the range 1-255."
+#endif
+
+#if defined(STEP_GENERATOR_DDA) && (STEP_DDA_TICK_RATE < 1000 || STEP_DDA_TICK_RATE > 200000)
+  #error "Step DDA tick rate must be in the range 1000-200000 Hz."
+#endif
 
 // ---------------------------------------------------------------------------------------
 
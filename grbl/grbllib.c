@@ -101,6 +101,9 @@ int grbl_enter (void)
     hal.limit_interrupt_callback = limit_interrupt_handler;
     hal.control_interrupt_callback = control_interrupt_handler;
     hal.stepper_interrupt_callback = stepper_driver_interrupt_handler;
+#ifdef SEGMENT_PREP_IRQ
+    hal.stepper_prep_callback = st_prep_irq_handler;
+#endif
     hal.stream.enqueue_realtime_command = protocol_enqueue_realtime_command;
     hal.stream_blocking_callback = stream_tx_blocking;
     hal.protocol_enqueue_gcode = protocol_enqueue_gcode;
@@ -162,7 +165,11 @@ int grbl_enter (void)
     sys.mpg_mode = false;
     sys.message = NULL;
 
+#ifdef SETTINGS_FROZEN
+    driver_ok = driver_ok && hal.driver_setup((settings_t *)&settings); // Drivers must not write to the settings.
+#else
     driver_ok = driver_ok && hal.driver_setup(&settings);
+#endif
 
 #ifdef ENABLE_SPINDLE_LINEARIZATION
     driver_ok = driver_ok && hal.driver_cap.spindle_pwm_linearization;
@@ -226,7 +233,7 @@ int grbl_enter (void)
         st_reset(); // Clear stepper subsystem variables.
         limits_set_homing_axes(); // Set axes to be homed from settings.
 #ifdef ENABLE_BACKLASH_COMPENSATION
-        mc_backlash_init(); // Init backlash configuration.
+        st_backlash_init(); // Init backlash configuration.
 #endif
         // Sync cleared gcode and planner positions to current system position.
         plan_sync_position();
@@ -33,7 +33,7 @@
 #include "eeprom.h"
 #include "stream.h"
 
-#define HAL_VERSION 6
+#define HAL_VERSION 7
 
 // driver capabilities, to be set by driver in driver_init(), flags may be cleared after to switch off option
 typedef union {
@@ -66,7 +66,8 @@ typedef union {
                  axis_ganged_z             :1,
                  mpg_mode                  :1,
                  spindle_pwm_linearization :1,
-                 unassigned                :4;
+                 limits_homing_irq         :1, // Limit pin change interrupts are enabled by limits_enable(true, true) for homing
+                 unassigned                :3;
     };
 } driver_cap_t;
 
@@ -136,7 +137,7 @@ typedef struct HAL {
     void (*spindle_set_state)(spindle_state_t state, float rpm);
     spindle_state_t (*spindle_get_state)(void);
 #ifdef SPINDLE_PWM_DIRECT
-    uint_fast16_t (*spindle_get_pwm)(float rpm);
+    uint_fast16_t (*spindle_get_pwm)(float rpm);     // Called by the segment generator, with SEGMENT_PREP_IRQ from interrupt context. Must not have side effects.
     void (*spindle_update_pwm)(uint_fast16_t pwm);
 #else
     void (*spindle_update_rpm)(float rpm);
@@ -152,6 +153,7 @@ typedef struct HAL {
 
     io_stream_t stream; // pointers to current I/O stream handlers
 
+    // NOTE: not used for the realtime execution flags when RT_FLAGS_LOCK_FREE is enabled and the processor has lock-free atomics.
     void (*set_bits_atomic)(volatile uint_fast16_t *value, uint_fast16_t bits);
     uint_fast16_t (*clear_bits_atomic)(volatile uint_fast16_t *value, uint_fast16_t bits);
     uint_fast16_t (*set_value_atomic)(volatile uint_fast16_t *value, uint_fast16_t bits);
@@ -159,6 +161,7 @@ typedef struct HAL {
     void (*settings_changed)(settings_t *settings);
 
     // optional entry points, may be unassigned (null)
+    // NOTE: plugins should subscribe to hooks (see hooks.h) rather than chain execute_realtime, driver_rt_report and driver_reset.
     bool (*driver_release)(void);
     bool (*probe_get_state)(void);
     void (*probe_configure_invert_mask)(bool is_probe_away);
@@ -184,6 +187,10 @@ typedef struct HAL {
     spindle_data_t (*spindle_get_data)(spindle_data_request_t request);
     void (*spindle_reset_data)(void);
     void (*state_change_requested)(uint_fast16_t state);
+    uint32_t (*get_elapsed_ticks)(void); // Milliseconds since startup, must be callable from interrupt context
+#ifdef SEGMENT_PREP_IRQ
+    void (*stepper_prep_request)(void); // Pends the low priority segment prep interrupt, see SEGMENT_PREP_IRQ in config.h
+#endif
 #ifdef DEBUGOUT
     void (*debug_out)(bool on);
 #endif
@@ -198,10 +205,13 @@ typedef struct HAL {
     // callbacks - set up by grbl before MCU init
     bool (*protocol_enqueue_gcode)(char *data);
     bool (*stream_blocking_callback)(void);
-    void (*stepper_interrupt_callback)(void);
+    void (*stepper_interrupt_callback)(void); // NOTE: may be changed by grbl at segment load, always call via the pointer
     void (*limit_interrupt_callback)(axes_signals_t state);
     void (*control_interrupt_callback)(control_signals_t signals);
     void (*spindle_index_callback)(spindle_data_t *rpm);
+#ifdef SEGMENT_PREP_IRQ
+    void (*stepper_prep_callback)(void); // To be called from the low priority segment prep interrupt
+#endif
 
     driver_cap_t driver_cap;
 } HAL;
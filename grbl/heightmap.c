@@ -0,0 +1,314 @@
+/*
+  heightmap.c - probed height map Z compensation
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef HEIGHT_MAP_COMPENSATION
+
+#define HEIGHT_MAP_PROBE_ARGS 7
+
+// Bilinear interpolation coefficients of a grid cell, z = a + b * u + c * v + d * u * v
+// where u and v are the X and Y distances from the cell origin in mm.
+typedef struct {
+    float a;
+    float b;
+    float c;
+    float d;
+} heightmap_cell_t;
+
+static struct {
+    bool valid;
+    bool enabled;
+    bool busy;
+    uint_fast8_t nx, ny;
+    float x0, y0;               // Grid origin in machine coordinates (mm).
+    float dx, dy;               // Grid spacing (mm).
+    float inv_dx, inv_dy;
+    float x_max, y_max;         // Grid extent, relative to origin (mm).
+    float z[HEIGHT_MAP_MAX_POINTS][HEIGHT_MAP_MAX_POINTS]; // Heights relative to the first point, [y][x].
+    heightmap_cell_t cell[HEIGHT_MAP_MAX_POINTS - 1][HEIGHT_MAP_MAX_POINTS - 1];
+} map = {0};
+
+// Returns the height map Z offset at the given position, outside the grid the height at the nearest edge is used.
+static float heightmap_z (float x, float y)
+{
+    uint_fast8_t ix, iy;
+    float u = x - map.x0, v = y - map.y0;
+
+    u = u < 0.0f ? 0.0f : (u > map.x_max ? map.x_max : u);
+    v = v < 0.0f ? 0.0f : (v > map.y_max ? map.y_max : v);
+
+    if((ix = (uint_fast8_t)(u * map.inv_dx)) > map.nx - 2)
+        ix = map.nx - 2;
+    if((iy = (uint_fast8_t)(v * map.inv_dy)) > map.ny - 2)
+        iy = map.ny - 2;
+
+    u -= (float)ix * map.dx;
+    v -= (float)iy * map.dy;
+
+    heightmap_cell_t *cell = &map.cell[iy][ix];
+
+    return cell->a + cell->b * u + v * (cell->c + cell->d * u);
+}
+
+bool heightmap_is_active (void)
+{
+    return map.enabled && !map.busy;
+}
+
+// Returns parameter value along the line of the first grid line crossing, and the parameter distance between crossings.
+static float heightmap_first_crossing (float start, float delta, float origin, float spacing, float inv_spacing, float *step)
+{
+    float t;
+
+    if(delta == 0.0f) {
+        *step = 0.0f;
+        return 2.0f; // Never.
+    }
+
+    *step = spacing / fabsf(delta);
+    t = (origin + (floorf((start - origin) * inv_spacing) + (delta > 0.0f ? 1.0f : 0.0f)) * spacing - start) / delta;
+
+    // Skip crossing at start, may be off by rounding.
+    return t <= *step * 0.001f ? t + *step : t;
+}
+
+// Splits line motion at grid cell boundaries, Z is linear within the cells along the split lines.
+// The start position is taken from the planner and thus includes the Z offset at that position.
+bool heightmap_line (float *target, plan_line_data_t *pl_data)
+{
+    bool ok;
+    uint_fast8_t idx;
+    float start[N_AXIS], delta[N_AXIS], segment[N_AXIS], t = 0.0f, t_prev, tx_next, ty_next, tx_step, ty_step;
+    float feed_rate = pl_data->feed_rate;
+
+    map.busy = true; // Pass compensated segments straight through mc_line().
+
+    plan_get_planner_mpos(start);
+    start[Z_AXIS] -= heightmap_z(start[X_AXIS], start[Y_AXIS]);
+
+    idx = N_AXIS;
+    do {
+        idx--;
+        delta[idx] = target[idx] - start[idx];
+    } while(idx);
+
+    tx_next = heightmap_first_crossing(start[X_AXIS], delta[X_AXIS], map.x0, map.dx, map.inv_dx, &tx_step);
+    ty_next = heightmap_first_crossing(start[Y_AXIS], delta[Y_AXIS], map.y0, map.dy, map.inv_dy, &ty_step);
+
+    do {
+        t_prev = t;
+        t = min(min(tx_next, ty_next), 1.0f);
+
+        if(t == tx_next)
+            tx_next += tx_step;
+        if(t == ty_next)
+            ty_next += ty_step;
+
+        if(t == 1.0f)
+            memcpy(segment, target, sizeof(segment));
+        else {
+            idx = N_AXIS;
+            do {
+                idx--;
+                segment[idx] = start[idx] + delta[idx] * t;
+            } while(idx);
+        }
+
+        segment[Z_AXIS] += heightmap_z(segment[X_AXIS], segment[Y_AXIS]);
+
+        // Scale inverse time feed rate to the fraction of the motion the segment covers.
+        if(pl_data->condition.inverse_time)
+            pl_data->feed_rate = feed_rate / (t - t_prev);
+
+        ok = mc_line(segment, pl_data);
+
+    } while(ok && t < 1.0f);
+
+    pl_data->feed_rate = feed_rate;
+    map.busy = false;
+
+    return ok;
+}
+
+// Probes the height map grid, starting from the current position as the first point.
+// Format: $ZP=<X length>,<Y length>,<X points>,<Y points>,<probe depth>,<clearance>,<feed rate>
+static status_code_t heightmap_probe (char *line)
+{
+    bool ok = true;
+    uint_fast8_t ix, iy, i, counter = 0, idx = 0;
+    float args[HEIGHT_MAP_PROBE_ARGS], position[N_AXIS], target[N_AXIS], probe[N_AXIS], z_clear;
+    plan_line_data_t plan_data;
+    gc_parser_flags_t flags = {0};
+
+    do {
+        if(!read_float(line, &counter, &args[idx]))
+            return Status_BadNumberFormat;
+    } while(++idx < HEIGHT_MAP_PROBE_ARGS && line[counter++] == ',');
+
+    if(idx != HEIGHT_MAP_PROBE_ARGS || line[counter] != '\0')
+        return Status_InvalidStatement;
+
+    if(args[0] <= 0.0f || args[1] <= 0.0f || args[4] <= 0.0f || args[5] <= 0.0f || args[6] <= 0.0f)
+        return Status_NonPositiveValue;
+
+    if(!(isintf(args[2]) && isintf(args[3])) ||
+        args[2] < 2.0f || args[2] > (float)HEIGHT_MAP_MAX_POINTS || args[3] < 2.0f || args[3] > (float)HEIGHT_MAP_MAX_POINTS)
+        return Status_GcodeValueOutOfRange;
+
+    if(sys.state != STATE_IDLE)
+        return Status_IdleError;
+
+    if(!hal.probe_get_state)
+        return Status_GcodeUnsupportedCommand;
+
+    map.enabled = map.valid = false;
+
+    system_convert_array_steps_to_mpos(position, sys_position);
+    memcpy(target, position, sizeof(target));
+
+    map.nx = (uint_fast8_t)args[2];
+    map.ny = (uint_fast8_t)args[3];
+    map.x0 = position[X_AXIS];
+    map.y0 = position[Y_AXIS];
+    map.x_max = args[0];
+    map.y_max = args[1];
+    map.dx = map.x_max / (float)(map.nx - 1);
+    map.dy = map.y_max / (float)(map.ny - 1);
+    map.inv_dx = 1.0f / map.dx;
+    map.inv_dy = 1.0f / map.dy;
+    z_clear = position[Z_AXIS] + args[5];
+
+    memset(&plan_data, 0, sizeof(plan_line_data_t));
+
+    // Probe grid in a serpentine pattern.
+    for(iy = 0; ok && iy < map.ny; iy++) {
+        for(i = 0; ok && i < map.nx; i++) {
+
+            ix = iy & 1 ? map.nx - 1 - i : i;
+
+            // Retract to clearance height and move to the probe point.
+            plan_data.condition.rapid_motion = On;
+            target[Z_AXIS] = z_clear;
+            mc_line(target, &plan_data);
+            target[X_AXIS] = map.x0 + (float)ix * map.dx;
+            target[Y_AXIS] = map.y0 + (float)iy * map.dy;
+            mc_line(target, &plan_data);
+
+            plan_data.condition.rapid_motion = Off;
+            plan_data.feed_rate = args[6];
+            target[Z_AXIS] = position[Z_AXIS] - args[4];
+
+            if((ok = mc_probe_cycle(target, &plan_data, flags) == GCProbe_Found)) {
+                system_convert_array_steps_to_mpos(probe, sys_probe_position);
+                map.z[iy][ix] = probe[Z_AXIS];
+            }
+        }
+    }
+
+    if(ok) {
+
+        plan_data.condition.rapid_motion = On;
+        target[Z_AXIS] = z_clear;
+        mc_line(target, &plan_data);
+        protocol_buffer_synchronize();
+
+        // Heights are relative to the first point.
+        z_clear = map.z[0][0];
+        for(iy = 0; iy < map.ny; iy++) {
+            for(ix = 0; ix < map.nx; ix++)
+                map.z[iy][ix] -= z_clear;
+        }
+
+        // Precompute the bilinear interpolation coefficients of the cells.
+        for(iy = 0; iy < map.ny - 1; iy++) {
+            for(ix = 0; ix < map.nx - 1; ix++) {
+                heightmap_cell_t *cell = &map.cell[iy][ix];
+                cell->a = map.z[iy][ix];
+                cell->b = (map.z[iy][ix + 1] - map.z[iy][ix]) * map.inv_dx;
+                cell->c = (map.z[iy + 1][ix] - map.z[iy][ix]) * map.inv_dy;
+                cell->d = (map.z[iy + 1][ix + 1] - map.z[iy][ix + 1] - map.z[iy + 1][ix] + map.z[iy][ix]) * map.inv_dx * map.inv_dy;
+            }
+        }
+
+        map.valid = map.enabled = !sys.abort;
+    }
+
+    if(!sys.abort) {
+        gc_sync_position();
+        plan_sync_position();
+    }
+
+    return ok ? Status_OK : Status_ProbeFailed;
+}
+
+// Reports height map origin, spacing and number of points followed by the heights row by row, in mm.
+static void heightmap_report (void)
+{
+    uint_fast8_t ix, iy;
+
+    hal.stream.write("[HMAP:");
+    hal.stream.write(ftoa(map.x0, N_DECIMAL_COORDVALUE_MM));
+    hal.stream.write(",");
+    hal.stream.write(ftoa(map.y0, N_DECIMAL_COORDVALUE_MM));
+    hal.stream.write(",");
+    hal.stream.write(ftoa(map.dx, N_DECIMAL_COORDVALUE_MM));
+    hal.stream.write(",");
+    hal.stream.write(ftoa(map.dy, N_DECIMAL_COORDVALUE_MM));
+    hal.stream.write(",");
+    hal.stream.write(uitoa((uint32_t)map.nx));
+    hal.stream.write(",");
+    hal.stream.write(uitoa((uint32_t)map.ny));
+    hal.stream.write(map.enabled ? ":1]" ASCII_EOL : ":0]" ASCII_EOL);
+
+    for(iy = 0; iy < map.ny; iy++) {
+        hal.stream.write("[HMAPZ:");
+        for(ix = 0; ix < map.nx; ix++) {
+            if(ix)
+                hal.stream.write(",");
+            hal.stream.write(ftoa(map.z[iy][ix], N_DECIMAL_COORDVALUE_MM));
+        }
+        hal.stream.write("]" ASCII_EOL);
+    }
+}
+
+// $Z reports the height map, $Z0 and $Z1 disables and enables compensation, $ZP=... probes a new height map.
+status_code_t heightmap_command (char *line)
+{
+    status_code_t retval = Status_OK;
+
+    if(line[0] == '\0') {
+        if(map.valid)
+            heightmap_report();
+        else
+            retval = Status_SettingReadFail;
+    } else if(line[0] == 'P' && line[1] == '=')
+        retval = heightmap_probe(&line[2]);
+    else if(line[1] != '\0' || !(line[0] == '0' || line[0] == '1'))
+        retval = Status_InvalidStatement;
+    else if(sys.state != STATE_IDLE)
+        retval = Status_IdleError; // Compensation must not change with motion queued.
+    else if(line[0] == '1' && !map.valid)
+        retval = Status_SettingReadFail;
+    else
+        map.enabled = line[0] == '1';
+
+    return retval;
+}
+
+#endif
@@ -0,0 +1,31 @@
+/*
+  heightmap.h - probed height map Z compensation
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef heightmap_h
+#define heightmap_h
+
+// Returns true if Z compensation is to be applied to line motions.
+bool heightmap_is_active (void);
+
+// Splits line motion at height map cell boundaries and passes the Z compensated segments on to mc_line().
+bool heightmap_line (float *target, plan_line_data_t *pl_data);
+
+// Executes $Z commands: report, enable/disable and probe the height map.
+status_code_t heightmap_command (char *line);
+
+#endif
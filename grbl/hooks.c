@@ -0,0 +1,49 @@
+/*
+  hooks.c - multi subscriber hook registry for plugins
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+hooks_t hooks = {0};
+
+void hook_add (hook_t *volatile *list, hook_t *hook)
+{
+    hook_t *volatile *link = list;
+
+    while(*link && (*link)->order <= hook->order) {
+        if(*link == hook)
+            return;
+        link = &(*link)->next;
+    }
+
+    // Complete the subscriber before publishing it with a single store.
+    hook->next = *link;
+    *link = hook;
+}
+
+void hook_remove (hook_t *volatile *list, hook_t *hook)
+{
+    hook_t *volatile *link = list;
+
+    while(*link) {
+        if(*link == hook) {
+            *link = hook->next; // Unlink with a single store, hook->next is left intact for a running dispatch.
+            break;
+        }
+        link = &(*link)->next;
+    }
+}
@@ -0,0 +1,66 @@
+/*
+  hooks.h - multi subscriber hook registry for plugins
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef hooks_h
+#define hooks_h
+
+// Plugins subscribe to hooks instead of saving and replacing HAL function pointers, so several plugins
+// can extend the same function without clobbering each other.
+// Subscriber structs are owned by the plugin and must be static. Subscribers are called in ascending order,
+// subscribers with the same order in the order added. An empty hook costs a single pointer test.
+// Adding and removing subscribers is done from the foreground. The lists are kept consistent for every
+// single pointer store, dispatch from interrupt context (step_pulse) is safe while a subscriber is added
+// or removed. A removed subscriber may be called once more by an interrupt already dispatching it.
+
+typedef struct hook {
+    union {
+        void (*step_pulse)(stepper_t *stepper);         // Called by the stepper ISR after the step pulse is started.
+        void (*execute_realtime)(uint_fast16_t state);  // Called from the realtime execution system.
+        void (*realtime_report)(stream_write_ptr stream_write, report_tracking_flags_t report); // Called at the end of the realtime report.
+        void (*reset)(void);                            // Called on soft reset and stop, after hal.driver_reset().
+    };
+    uint8_t order;
+    struct hook *volatile next;                         // Set by the registry.
+} hook_t;
+
+typedef struct {
+    hook_t *volatile step_pulse;
+    hook_t *volatile execute_realtime;
+    hook_t *volatile realtime_report;
+    hook_t *volatile reset;
+} hooks_t;
+
+extern hooks_t hooks;
+
+// Adds a subscriber to a hook list, e.g. hook_add(&hooks.step_pulse, &my_hook). Adding a subscriber twice is ignored.
+void hook_add (hook_t *volatile *list, hook_t *hook);
+
+// Removes a subscriber from a hook list.
+void hook_remove (hook_t *volatile *list, hook_t *hook);
+
+// Calls all subscribers of a hook, e.g. hooks_dispatch(step_pulse, stepper);
+#define hooks_dispatch(list, ...) \
+    do { \
+        hook_t *hook = hooks.list; \
+        while(hook) { \
+            hook->list(__VA_ARGS__); \
+            hook = hook->next; \
+        } \
+    } while(0)
+
+#endif
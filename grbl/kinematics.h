@@ -29,6 +29,9 @@ typedef struct {
     uint_fast8_t (*limits_get_axis_mask)(uint_fast8_t idx);
     void (*limits_set_target_pos)(uint_fast8_t idx);
     void (*limits_set_machine_positions)(axes_signals_t cycle);
+    // Optional: if set, non-linear motions are planned as single blocks in cartesian space and the step segment
+    // generator calls this to convert the end position of each segment to motor steps.
+    void (*segment_target_to_steps)(int32_t *target_steps, float *target);
 } kinematics_t;
 
 extern kinematics_t kinematics;
@@ -42,8 +42,46 @@
 // special pinout for an e-stop, but it is generally recommended to just directly connect
 // your e-stop switch to the microcontroller reset pin, since it is the most correct way to do this.
 
+#ifdef ENABLE_HOMING_LIMIT_LATCH
+
+static struct {
+    volatile axes_signals_t armed;  // Axes to latch the position of on limit switch trigger
+    axes_signals_t motors;          // Motors moved by the homing cycle
+    uint_fast8_t step_pin[N_AXIS];  // Motors to lock out per axis
+    int32_t position[N_AXIS];       // Motor positions latched at the switch trigger
+    int32_t overshoot[N_AXIS];      // Motor steps moved past the switch trigger in the last approach
+} homing_latch;
+
+// Latches motor positions and locks out the motors of the triggered limit switches.
+ISR_CODE static void homing_latch_limits (axes_signals_t state)
+{
+    uint_fast8_t idx = N_AXIS, motor;
+
+    if((state.mask &= homing_latch.armed.mask)) do {
+        if(state.mask & bit(--idx)) {
+            sys.homing_axis_lock.mask &= ~homing_latch.step_pin[idx];
+            motor = N_AXIS;
+            do {
+                if(homing_latch.step_pin[idx] & bit(--motor))
+                    homing_latch.position[motor] = sys_position[motor];
+            } while(motor);
+        }
+    } while(idx);
+
+    homing_latch.armed.mask &= ~state.mask;
+}
+
+#endif
+
 ISR_CODE void limit_interrupt_handler (axes_signals_t state) // DEFAULT: Limit pin change interrupt process.
 {
+#ifdef ENABLE_HOMING_LIMIT_LATCH
+    if (sys.state == STATE_HOMING) {
+        homing_latch_limits(state);
+        return;
+    }
+#endif
+
     // Ignore limit switches if already in an alarm state or in-process of executing an alarm.
     // When in the alarm state, Grbl should have been reset or will force a reset, so any pending
     // moves in the planner and stream input buffers are all cleared and newly sent blocks will be
@@ -106,6 +144,13 @@ static bool limits_homing_cycle (axes_signals_t cycle)
     float homing_rate = settings.homing.seek_rate;
     axes_signals_t axislock;
     plan_line_data_t plan_data;
+#ifdef ENABLE_HOMING_LIMIT_LATCH
+    bool latch = hal.driver_cap.limits_homing_irq;
+
+    memset(homing_latch.overshoot, 0, sizeof(homing_latch.overshoot));
+#else
+    const bool latch = false;
+#endif
 
     // Initialize plan data struct for homing motion.
 
@@ -166,18 +211,33 @@ static bool limits_homing_cycle (axes_signals_t cycle)
         homing_rate *= sqrtf(n_active_axis); // [sqrt(N_AXIS)] Adjust so individual axes all move at homing rate.
         sys.homing_axis_lock.mask = axislock.mask;
 
+#ifdef ENABLE_HOMING_LIMIT_LATCH
+        if (latch && approach) {
+            memcpy(homing_latch.step_pin, step_pin, sizeof(step_pin));
+            homing_latch.motors = axislock;
+            homing_latch.armed = cycle;
+            hal.limits_enable(true, true);
+            homing_latch_limits(hal.limits_get_state()); // Latch switches already engaged.
+        }
+#endif
+
         // Perform homing cycle. Planner buffer should be empty, as required to initiate the homing cycle.
         plan_data.feed_rate = homing_rate; // Set current homing rate.
         plan_buffer_line(target, &plan_data); // Bypass mc_line(). Directly plan homing motion.
 
+        st_prep_lock();
         sys.step_control.flags = 0;
         sys.step_control.execute_sys_motion = On; // Set to execute homing motion and clear existing flags.
+        st_prep_unlock();
         st_prep_buffer(); // Prep and fill segment buffer from newly planned block.
         st_wake_up(); // Initiate motion
 
         do {
 
-            if (approach) {
+            if (approach && latch)
+                axislock.mask = sys.homing_axis_lock.mask; // Locked out by the limit pin change interrupt.
+
+            else if (approach) {
                 // Check limit state. Lock out cycle axes when they change.
                 limit_state = hal.limits_get_state().value;
 
@@ -232,6 +292,18 @@ static bool limits_homing_cycle (axes_signals_t cycle)
 
         } while (axislock.mask & AXES_BITMASK);
 
+#ifdef ENABLE_HOMING_LIMIT_LATCH
+        if (latch && approach) {
+            hal.limits_enable(false, true);
+            homing_latch.armed.mask = 0;
+            idx = N_AXIS;
+            do {
+                if (homing_latch.motors.mask & bit(--idx))
+                    homing_latch.overshoot[idx] = sys_position[idx] - homing_latch.position[idx];
+            } while(idx);
+        }
+#endif
+
         st_reset(); // Immediately force kill steppers and reset step segment buffer.
         hal.delay_ms(settings.homing.debounce_delay, 0); // Delay to allow transient dynamics to dissipate.
 
@@ -261,8 +333,19 @@ static bool limits_homing_cycle (axes_signals_t cycle)
     limits_set_machine_positions(cycle, true);
 #endif
 
+#ifdef ENABLE_HOMING_LIMIT_LATCH
+    // The pull-off started from where the motors stopped, past the latched trigger positions.
+    if (latch) {
+        idx = N_AXIS;
+        do {
+            idx--;
+            sys_position[idx] += homing_latch.overshoot[idx];
+        } while(idx);
+    }
+#endif
+
 #ifdef ENABLE_BACKLASH_COMPENSATION
-    mc_backlash_init();
+    st_backlash_init();
 #endif
     sys.step_control.flags = 0; // Return step control to normal operation.
     sys.homed.mask |= cycle.mask;
@@ -40,6 +40,7 @@ typedef struct {
     float halfWidth;        //Half the machine width
     float halfHeight;       //Half the machine height
     float xCordOfMotor;
+    float xCordOfMotor_x2;
     float xCordOfMotor_x4;
     float xCordOfMotor_x2_pow;
     float yCordOfMotor;
@@ -317,6 +318,7 @@ void recomputeGeometry()
     machine.halfHeight = (maslow_hal.settings->machineHeight / 2.0f);
     machine.xCordOfMotor = (maslow_hal.settings->distBetweenMotors / 2.0f);
     machine.yCordOfMotor = (machine.halfHeight + maslow_hal.settings->motorOffsetY);
+    machine.xCordOfMotor_x2 = machine.xCordOfMotor * 2.0f;
     machine.xCordOfMotor_x4 = machine.xCordOfMotor * 4.0f;
     machine.xCordOfMotor_x2_pow = powf((machine.xCordOfMotor * 2.0f), 2.0f);
 }
@@ -360,13 +362,16 @@ inline static void triangularInverse (int32_t *target_steps, float *target)
 //    verifyValidTarget(&xTarget, &yTarget);
 
     // scale target (absolute position) by any correction factor
-    double xxx = (double)target[A_MOTOR] * (double)maslow_hal.settings->XcorrScaling;
-    double yyy = (double)target[B_MOTOR] * (double)maslow_hal.settings->YcorrScaling;
-    double yyp = pow((double)machine.yCordOfMotor - yyy, 2.0);
+    // NOTE: single precision only as this is called for every step segment.
+    float xxx = target[A_MOTOR] * maslow_hal.settings->XcorrScaling;
+    float yyy = machine.yCordOfMotor - target[B_MOTOR] * maslow_hal.settings->YcorrScaling;
+    float yyp = yyy * yyy;
 
     //Calculate motor axes length to the bit
-    target_steps[A_MOTOR] = (int32_t)lround(sqrt(pow((double)machine.xCordOfMotor + xxx, 2.0f) + yyp) * settings.steps_per_mm[A_MOTOR]);
-    target_steps[B_MOTOR] = (int32_t)lround(sqrt(pow((double)machine.xCordOfMotor - xxx, 2.0f) + yyp) * settings.steps_per_mm[B_MOTOR]);
+    xxx += machine.xCordOfMotor;
+    target_steps[A_MOTOR] = (int32_t)lroundf(sqrtf(xxx * xxx + yyp) * settings.steps_per_mm[A_MOTOR]);
+    xxx = machine.xCordOfMotor_x2 - xxx;
+    target_steps[B_MOTOR] = (int32_t)lroundf(sqrtf(xxx * xxx + yyp) * settings.steps_per_mm[B_MOTOR]);
 }
 
 // Transform absolute position from cartesian coordinate system (mm) to maslow coordinate system (step)
@@ -386,58 +391,17 @@ static uint_fast8_t maslow_limits_get_axis_mask (uint_fast8_t idx)
     return ((idx == A_MOTOR) || (idx == B_MOTOR)) ? (bit(X_AXIS) | bit(Y_AXIS)) : bit(idx);
 }
 
-// MASLOW is circular in motion, so long lines must be divided up
+// Lines are planned as single blocks in cartesian space and the step segment generator converts
+// each step segment to motor steps, so there is no need to divide them up here.
 static bool maslow_segment_line (float *target, plan_line_data_t *pl_data, bool init)
 {
-    static uint_fast16_t iterations;
-    static bool segmented;
-    static float delta[N_AXIS], segment_target[N_AXIS];
-//    static plan_line_data_t plan;
-
-    uint_fast8_t idx = N_AXIS;
-
-    if(init) {
-
-        float max_delta = 0.0f;
-
-        do {
-            idx--;
-            delta[idx] = target[idx] - gc_state.position[idx];
-            max_delta = max(max_delta, fabsf(delta[idx]));
-        } while(idx);
-
-        if((segmented = !(pl_data->condition.rapid_motion || pl_data->condition.jog_motion) &&
-                          max_delta > MAX_SEG_LENGTH_MM && !(delta[X_AXIS] == 0.0f && delta[Y_AXIS] == 0.0f))) {
-
-            idx = N_AXIS;
-            iterations = (uint_fast16_t)ceilf(max_delta / MAX_SEG_LENGTH_MM);
-
-            memcpy(segment_target, gc_state.position, sizeof(segment_target));
-//            memcpy(&plan, pl_data, sizeof(plan_line_data_t));
-
-            do {
-                delta[--idx] /= (float)iterations;
-                target[idx] = gc_state.position[idx];
-            } while(idx);
-
-        } else
-            iterations = 1;
-
-        iterations++; // return at least one iteration
-
-    } else {
+    static uint_fast8_t iterations;
 
+    if(init)
+        iterations = 2; // return one iteration
+    else
         iterations--;
 
-        if(segmented && iterations) do {
-            idx--;
-            segment_target[idx] += delta[idx];
-            target[idx] = segment_target[idx];
-//            memcpy(pl_data, &plan, sizeof(plan_line_data_t));
-        } while(idx);
-
-    }
-
     return iterations != 0;
 }
 
@@ -745,6 +709,7 @@ void maslow_init (void)
     kinematics.plan_target_to_steps = maslow_target_to_steps;
     kinematics.convert_array_steps_to_mpos = maslow_convert_array_steps_to_mpos;
     kinematics.segment_line = maslow_segment_line;
+    kinematics.segment_target_to_steps = maslow_target_to_steps;
 
     hal.driver_sys_command_execute = maslow_tuning;
 }
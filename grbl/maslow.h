@@ -36,7 +36,6 @@
 
 #define FP_SCALING 1024.0f
 #define SPROCKET_RADIUS_MM (10.1f)
-#define MAX_SEG_LENGTH_MM 2.0f /* long lines must be segmented due to circular motion */
 
   // PID position loop factors              X: Kp = 25000 Ki = 15000 Kd = 22000 Imax = 5000
   // 14.000 fixed point arithmatic S13.10
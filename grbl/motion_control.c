@@ -26,36 +26,6 @@
 
 #include "grbl.h"
 
-#ifdef ENABLE_BACKLASH_COMPENSATION
-
-static float target_prev[N_AXIS];
-static axes_signals_t dir_negative, backlash_enabled;
-
-void mc_backlash_init (void)
-{
-    uint_fast8_t idx = N_AXIS;
-
-    backlash_enabled.mask = dir_negative.value = 0;
-
-    do {
-        if(settings.backlash[--idx] > 0.0001f)
-            backlash_enabled.mask |= bit(idx);
-        dir_negative.value |= bit(idx);
-    } while(idx);
-
-    dir_negative.value ^= settings.homing.dir_mask.value;
-
-    mc_sync_backlash_position();
-}
-
-void mc_sync_backlash_position (void)
-{
-    // Update target_prev
-    system_convert_array_steps_to_mpos(target_prev, sys_position);
-}
-
-#endif
-
 // Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
 // unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
 // (1 minute)/feed_rate time.
@@ -65,6 +35,17 @@ void mc_sync_backlash_position (void)
 // in the planner and to let backlash compensation or canned cycle integration simple and direct.
 bool mc_line (float *target, plan_line_data_t *pl_data)
 {
+#ifdef HEIGHT_MAP_COMPENSATION
+    // Apply Z compensation from the probed height map, motion is split at grid cell boundaries.
+    if(heightmap_is_active() && !pl_data->condition.system_motion)
+        return heightmap_line(target, pl_data);
+#endif
+
+#ifdef SPINDLE_SPINUP_OVERLAP
+    // Hold back first feed motion after spindle start until spindle is at speed.
+    if(!(pl_data->condition.rapid_motion || pl_data->condition.jog_motion) && spindle_spinup_pending() && !spindle_spinup_wait())
+        return false;
+#endif
 
     // If enabled, check for soft limit violations. Placed here all line motions are picked up
     // from everywhere in Grbl.
@@ -89,58 +70,6 @@ bool mc_line (float *target, plan_line_data_t *pl_data)
         // doesn't update the machine position values. Since the position values used by the g-code
         // parser and planner are separate from the system machine positions, this is doable.
 
-#ifdef ENABLE_BACKLASH_COMPENSATION
-
-        if(backlash_enabled.mask) {
-
-            bool backlash_comp = false;
-            uint_fast8_t idx = N_AXIS, axismask = bit(N_AXIS - 1);
-
-            do {
-                idx--;
-                if(backlash_enabled.mask & axismask) {
-                    if(target[idx] > target_prev[idx]) {
-                        if (dir_negative.value & axismask) {
-                            dir_negative.value &= ~axismask;
-                            target_prev[idx] += settings.backlash[idx];
-                            backlash_comp = true;
-                        }
-                    } else if(target[idx] < target_prev[idx] && !(dir_negative.value & axismask)) {
-                        dir_negative.value |= axismask;
-                        target_prev[idx] -= settings.backlash[idx];
-                        backlash_comp = true;
-                    }
-                }
-                axismask >>= 1;
-            } while(idx);
-
-            if(backlash_comp) {
-
-                plan_line_data_t pl_backlash;
-
-                memset(&pl_backlash, 0, sizeof(plan_line_data_t));
-
-                pl_backlash.condition.rapid_motion = On;
-                pl_backlash.condition.backlash_motion = On;
-                pl_backlash.line_number = pl_data->line_number;
-                pl_backlash.spindle.rpm = pl_data->spindle.rpm;
-
-                // If the buffer is full: good! That means we are well ahead of the robot.
-                // Remain in this loop until there is room in the buffer.
-                while(plan_check_full_buffer()) {
-                    protocol_auto_cycle_start();     // Auto-cycle start when buffer is full.
-                    if(!protocol_execute_realtime()) // Check for any run-time commands
-                        return false;                // Bail, if system abort.
-                }
-
-                plan_buffer_line(target_prev, &pl_backlash);
-            }
-
-            memcpy(target_prev, target, sizeof(float) * N_AXIS);
-        }
-
-#endif // Backlash comp
-
 #ifdef KINEMATICS_API
      kinematics.segment_line(target, pl_data, true);
 
@@ -283,179 +212,149 @@ void mc_arc (float *target, plan_line_data_t *pl_data, float *position, float *o
             position[plane.axis_linear] += linear_per_segment;
 
             // Bail mid-circle on system abort. Runtime command check already performed by mc_line.
-            if(!mc_line(position, pl_data))
+            if(!mc_line(position, pl_data)) {
+                pl_data->arc_radius = 0.0f;
                 return;
+            }
+
+            // Tag following segments with the arc radius for the planner junction speed calculation.
+            pl_data->arc_radius = radius;
         }
     }
+
     // Ensure last segment arrives at target location.
     mc_line(target, pl_data);
+
+    pl_data->arc_radius = 0.0f;
 }
 
-// Bezier splines, from a pull request for Marlin
+// Bezier splines, based on a pull request for Marlin
 // By Giovanni Mascellani - https://github.com/giomasce/Marlin
 
-// Compute the linear interpolation between two real numbers.
-static inline float interp(const float a, const float b, const float t)
+// Cubic polynomial coefficients of the X and Y components of the curve: P(t) = a*t^3 + b*t^2 + c*t + P0
+typedef struct {
+    float a[2];
+    float b[2];
+    float c[2];
+} bezier_t;
+
+// Forward differences of the curve at t for step size h.
+typedef struct {
+    float d1[2];
+    float d2[2];
+    float d3[2];
+} bezier_diff_t;
+
+// Computes the forward differences from the polynomial, called on start and when the step size changes.
+static void bezier_differences (bezier_t *bez, bezier_diff_t *diff, float t, float h)
 {
-    return (1.0f - t) * a + t * b;
+    uint_fast8_t idx = 2;
+    float h2 = h * h, h3 = h2 * h;
+
+    do {
+        idx--;
+        float p1 = (3.0f * bez->a[idx] * t + 2.0f * bez->b[idx]) * t + bez->c[idx], // 1st derivative
+              p2 = 6.0f * bez->a[idx] * t + 2.0f * bez->b[idx],                     // 2nd derivative
+              p3 = 6.0f * bez->a[idx];                                              // 3rd derivative
+        diff->d1[idx] = p1 * h + p2 * h2 * 0.5f + p3 * h3 * (1.0f / 6.0f);
+        diff->d2[idx] = p2 * h2 + p3 * h3;
+        diff->d3[idx] = p3 * h3;
+    } while(idx);
 }
 
-/**
- * Compute a Bzier curve using the De Casteljau's algorithm (see
- * https://en.wikipedia.org/wiki/De_Casteljau's_algorithm), which is
- * easy to code and has good numerical stability (very important,
- * since Arudino works with limited precision real numbers).
- */
-static inline float eval_bezier(const float a, const float b, const float c, const float d, const float t)
+// Estimates the chord error of the next step as |P''|*h^2/8 at the step midpoint, from the
+// second and third forward differences. Norm 1 is used as it is quicker to compute.
+static inline float bezier_chord_error (bezier_diff_t *diff)
 {
-    const float iab = interp(a, b, t),
-                ibc = interp(b, c, t),
-                icd = interp(c, d, t),
-                iabc = interp(iab, ibc, t),
-                ibcd = interp(ibc, icd, t);
-
-    return interp(iabc, ibcd, t);
+    return (fabsf(diff->d2[X_AXIS] - 0.5f * diff->d3[X_AXIS]) + fabsf(diff->d2[Y_AXIS] - 0.5f * diff->d3[Y_AXIS])) * 0.125f;
 }
 
-/**
- * We approximate Euclidean distance with the sum of the coordinates
- * offset (so-called "norm 1"), which is quicker to compute.
- */
-static inline float dist1(const float x1, const float y1, const float x2, const float y2)
+// Returns maximum speed (mm/min) at t limited by centripetal acceleration at the curvature of the curve,
+// v = sqrt(acceleration / curvature) where curvature = |P' x P''| / |P'|^3.
+static float bezier_max_speed (bezier_t *bez, float t, float acceleration)
 {
-    return fabsf(x1 - x2) + fabsf(y1 - y2);
+    float p1x = (3.0f * bez->a[X_AXIS] * t + 2.0f * bez->b[X_AXIS]) * t + bez->c[X_AXIS],
+          p1y = (3.0f * bez->a[Y_AXIS] * t + 2.0f * bez->b[Y_AXIS]) * t + bez->c[Y_AXIS],
+          p2x = 6.0f * bez->a[X_AXIS] * t + 2.0f * bez->b[X_AXIS],
+          p2y = 6.0f * bez->a[Y_AXIS] * t + 2.0f * bez->b[Y_AXIS],
+          cross = fabsf(p1x * p2y - p1y * p2x),
+          speed_sqr = p1x * p1x + p1y * p1y;
+
+    return cross == 0.0f ? SOME_LARGE_VALUE : sqrtf(acceleration * speed_sqr * sqrtf(speed_sqr) / cross);
 }
 
 /**
- * The algorithm for computing the step is loosely based on the one in Kig
- * (See https://sources.debian.net/src/kig/4:15.08.3-1/misc/kigpainter.cpp/#L759)
- * However, we do not use the stack.
- *
- * The algorithm goes as it follows: the parameters t runs from 0.0 to
- * 1.0 describing the curve, which is evaluated by eval_bezier(). At
- * each iteration we have to choose a step, i.e., the increment of the
- * t variable. By default the step of the previous iteration is taken,
- * and then it is enlarged or reduced depending on how straight the
- * curve locally is. The step is always clamped between MIN_STEP/2 and
- * 2*MAX_STEP. MAX_STEP is taken at the first iteration.
- *
- * For some t, the step value is considered acceptable if the curve in
- * the interval [t, t+step] is sufficiently straight, i.e.,
- * sufficiently close to linear interpolation. In practice the
- * following test is performed: the distance between eval_bezier(...,
- * t+step/2) is evaluated and compared with 0.5*(eval_bezier(...,
- * t)+eval_bezier(..., t+step)). If it is smaller than SIGMA, then the
- * step value is considered acceptable, otherwise it is not. The code
- * seeks to find the larger step value which is considered acceptable.
+ * The curve is converted to the power basis and traced by forward differencing, requiring only additions per
+ * step. The step size in t is halved while the estimated chord error exceeds BEZIER_SIGMA and doubled while it
+ * stays below a quarter of it (the error scales with the step size squared), clamped between BEZIER_MIN_STEP
+ * and BEZIER_MAX_STEP. The forward differences are recomputed from the polynomial on each step size change
+ * so that round-off does not accumulate across them.
  *
- * At every iteration the recorded step value is considered and then
- * iteratively halved until it becomes acceptable. If it was already
- * acceptable in the beginning (i.e., no halving were done), then
- * maybe it was necessary to enlarge it; then it is iteratively
- * doubled while it remains acceptable. The last acceptable value
- * found is taken, provided that it is between MIN_STEP and MAX_STEP
- * and does not bring t over 1.0.
- *
- * Caveat: this algorithm is not perfect, since it can happen that a
- * step is considered acceptable even when the curve is not linear at
- * all in the interval [t, t+step] (but its mid point coincides "by
- * chance" with the midpoint according to the parametrization). This
- * kind of glitches can be eliminated with proper first derivative
- * estimates; however, given the improbability of such configurations,
- * the mitigation offered by MIN_STEP and the small computational
- * power available on Arduino, I think it is not wise to implement it.
+ * The feed rate of each segment is limited by centripetal acceleration at the segment midpoint curvature so that
+ * tight sections of the curve are not executed at a speed the planner has to brake for at every segment junction.
  */
-
 void mc_cubic_b_spline (float *target, plan_line_data_t *pl_data, float *position, float *offset1, float *offset2)
 {
-    // Absolute first and second control points are recovered.
+    uint_fast8_t idx = 2;
+    bezier_t bez;
+    bezier_diff_t diff;
+    float bez_target[N_AXIS], t = 0.0f, step = BEZIER_MAX_STEP, feed_rate = pl_data->feed_rate;
+    float acceleration = min(settings.acceleration[X_AXIS], settings.acceleration[Y_AXIS]);
 
-    float first[2] = { position[X_AXIS] + offset1[X_AXIS], position[Y_AXIS] + offset1[Y_AXIS] };
-    float second[2] = { target[X_AXIS] + offset2[X_AXIS], target[Y_AXIS] + offset2[Y_AXIS] };
-    float bez_target[N_AXIS];
+    // Absolute first and second control points are recovered and the curve converted to power basis.
+    do {
+        idx--;
+        float p0 = position[idx], p1 = position[idx] + offset1[idx], p2 = target[idx] + offset2[idx], p3 = target[idx];
+        bez.a[idx] = p3 - p0 + 3.0f * (p1 - p2);
+        bez.b[idx] = 3.0f * (p0 - 2.0f * p1 + p2);
+        bez.c[idx] = 3.0f * (p1 - p0);
+    } while(idx);
 
     memcpy(bez_target, position, sizeof(float) * N_AXIS);
 
-    float t = 0.0f, step = BEZIER_MAX_STEP;
+    bezier_differences(&bez, &diff, t, step);
 
     while (t < 1.0f) {
 
-        // First try to reduce the step in order to make it sufficiently
-        // close to a linear interpolation.
-        bool did_reduce = false;
-        float new_t = t + step;
-
-        if(new_t > 1.0f)
-            new_t = 1.0f;
-
-        float new_pos0 = eval_bezier(position[X_AXIS], first[X_AXIS], second[X_AXIS], target[X_AXIS], new_t),
-              new_pos1 = eval_bezier(position[Y_AXIS], first[Y_AXIS], second[Y_AXIS], target[Y_AXIS], new_t);
-
-        while(new_t - t >= (BEZIER_MIN_STEP)) {
-
-//            if (new_t - t < (BEZIER_MIN_STEP))
-//                break;
-
-            const float candidate_t = 0.5f * (t + new_t),
-                      candidate_pos0 = eval_bezier(position[X_AXIS], first[X_AXIS], second[X_AXIS], target[X_AXIS], candidate_t),
-                      candidate_pos1 = eval_bezier(position[Y_AXIS], first[Y_AXIS], second[Y_AXIS], target[Y_AXIS], candidate_t),
-                      interp_pos0 = 0.5f * (bez_target[X_AXIS] + new_pos0),
-                      interp_pos1 = 0.5f * (bez_target[Y_AXIS] + new_pos1);
-
-            if (dist1(candidate_pos0, candidate_pos1, interp_pos0, interp_pos1) <= (BEZIER_SIGMA))
-                break;
-
-            new_t = candidate_t;
-            new_pos0 = candidate_pos0;
-            new_pos1 = candidate_pos1;
-            did_reduce = true;
+        if(bezier_chord_error(&diff) > BEZIER_SIGMA) {
+            // Reduce the step until the segment is sufficiently close to a linear interpolation of the curve.
+            do {
+                step *= 0.5f;
+                bezier_differences(&bez, &diff, t, step);
+            } while(step > BEZIER_MIN_STEP && bezier_chord_error(&diff) > BEZIER_SIGMA);
+        } else if(step < BEZIER_MAX_STEP && bezier_chord_error(&diff) * 4.0f <= BEZIER_SIGMA) {
+            // If we did not reduce the step, maybe we should enlarge it.
+            do {
+                step *= 2.0f;
+                bezier_differences(&bez, &diff, t, step);
+            } while(step < BEZIER_MAX_STEP && bezier_chord_error(&diff) * 4.0f <= BEZIER_SIGMA);
         }
 
-        // If we did not reduce the step, maybe we should enlarge it.
-        if (!did_reduce) while (new_t - t <= BEZIER_MAX_STEP) {
+        if(!pl_data->condition.inverse_time)
+            pl_data->feed_rate = min(feed_rate, bezier_max_speed(&bez, min(t + step * 0.5f, 1.0f), acceleration));
 
-//            if (new_t - t > BEZIER_MAX_STEP)
-//                break;
-
-            const float candidate_t = t + 2.0f * (new_t - t);
-
-            if (candidate_t >= 1.0f)
-                break;
-
-            const float candidate_pos0 = eval_bezier(position[X_AXIS], first[X_AXIS], second[X_AXIS], target[X_AXIS], candidate_t),
-                      candidate_pos1 = eval_bezier(position[Y_AXIS], first[Y_AXIS], second[Y_AXIS], target[Y_AXIS], candidate_t),
-                      interp_pos0 = 0.5f * (bez_target[X_AXIS] + candidate_pos0),
-                      interp_pos1 = 0.5f * (bez_target[Y_AXIS] + candidate_pos1);
-
-            if (dist1(new_pos0, new_pos1, interp_pos0, interp_pos1) > (BEZIER_SIGMA))
-                break;
-
-            new_t = candidate_t;
-            new_pos0 = candidate_pos0;
-            new_pos1 = candidate_pos1;
+        if(t + step >= 1.0f) {
+            // Last segment, ensure it arrives at target location.
+            t = 1.0f;
+            bez_target[X_AXIS] = target[X_AXIS];
+            bez_target[Y_AXIS] = target[Y_AXIS];
+        } else {
+            t += step;
+            idx = 2;
+            do {
+                idx--;
+                bez_target[idx] += diff.d1[idx];
+                diff.d1[idx] += diff.d2[idx];
+                diff.d2[idx] += diff.d3[idx];
+            } while(idx);
         }
 
-        // Check some postcondition; they are disabled in the actual
-        // Marlin build, but if you test the same code on a computer you
-        // may want to check they are respect.
-        /*
-          assert(new_t <= 1.0);
-          if (new_t < 1.0) {
-            assert(new_t - t >= (MIN_STEP) / 2.0);
-            assert(new_t - t <= (MAX_STEP) * 2.0);
-          }
-        */
-
-        step = new_t - t;
-        t = new_t;
-
-        bez_target[X_AXIS] = new_pos0;
-        bez_target[Y_AXIS] = new_pos1;
-
         // Bail mid-spline on system abort. Runtime command check already performed by mc_line.
         if(!mc_line(bez_target, pl_data))
-            return;
+            break;
     }
+
+    pl_data->feed_rate = feed_rate;
 }
 
 // end Bezier splines
@@ -503,11 +402,11 @@ void mc_canned_drill (motion_mode_t motion, float *target, plan_line_data_t *pl_
             if(!mc_line(position, pl_data)) // drill
                 return;
 
-            if(canned->dwell > 0.0f)
-                mc_dwell(canned->dwell);
+            if(canned->dwell > 0.0f && !mc_buffered_dwell(canned->dwell, pl_data))
+                return;
 
             if(canned->spindle_off)
-                hal.spindle_set_state((spindle_state_t){0}, 0.0f);
+                spindle_sync((spindle_state_t){0}, 0.0f);
 
             // rapid retract
             switch(motion) {
@@ -713,6 +612,176 @@ status_code_t mc_jog_execute (plan_line_data_t *pl_data, parser_block_t *gc_bloc
     return Status_OK;
 }
 
+// Continuous (velocity mode) jogging state, see mc_jog_continuous().
+static struct {
+    volatile bool active;
+    volatile bool pending;      // Start or change requested, picked up by mc_jog_continuous_update().
+    bool busy;
+    struct {
+        float direction[N_AXIS];
+        float speed;
+        float max_distance;
+    } request;
+    float speed;                // Requested speed (mm/min).
+    float block_mm;             // Length of each queued block (mm).
+    float horizon_mm;           // Distance to keep queued ahead of the machine (mm).
+    float remaining_mm;         // Distance left before the travel limit of the jog is reached (mm), 0 for none.
+    float unit_vec[N_AXIS];     // Direction of motion.
+    float target[N_AXIS];       // End position of the last queued block (mm).
+    plan_line_data_t pl_data;
+} jog_cont = {0};
+
+// Start a continuous (velocity mode) jog, or change direction and speed of the active one, for keypads
+// and MPGs. The direction vector need not be normalized. Unlike jogging with $J= the motion is not
+// queued in full upfront, mc_jog_continuous_update() keeps adding short blocks for as long as the jog
+// is active, only so far ahead as needed to reach and hold the requested speed. The machine thus
+// comes to a controlled stop within the deceleration distance plus one block after
+// mc_jog_continuous_stop() is called, without a motion cancel and buffer flush.
+// If max_distance is not zero the jog will stop by itself after having traveled that distance.
+// NOTE: May be called from hal.execute_realtime, thus possibly while a g-code block is executing. The request
+//       is only recorded here, it is started by mc_jog_continuous_update() from the main loop between lines.
+status_code_t mc_jog_continuous (float *direction, float speed, float max_distance)
+{
+    float unit_vec[N_AXIS];
+
+    if (!(sys.state == STATE_IDLE || (sys.state & (STATE_JOG|STATE_TOOL_CHANGE))) || sys.suspend)
+        return Status_IdleError;
+
+    memcpy(unit_vec, direction, sizeof(unit_vec));
+
+    if(speed <= 0.0f || convert_delta_vector_to_unit_vector(unit_vec) == 0.0f) {
+        mc_jog_continuous_stop();
+        return Status_OK;
+    }
+
+    jog_cont.pending = false;
+    memcpy(jog_cont.request.direction, unit_vec, sizeof(unit_vec));
+    jog_cont.request.speed = speed;
+    jog_cont.request.max_distance = max_distance;
+    jog_cont.pending = true;
+
+    return Status_OK;
+}
+
+// Starts or changes the requested continuous jog, the gcode and planner positions are in sync here.
+static void jog_continuous_start (void)
+{
+    float *unit_vec = jog_cont.request.direction, acceleration;
+
+    jog_cont.active = false;
+
+    if (!(sys.state == STATE_IDLE || (sys.state & (STATE_JOG|STATE_TOOL_CHANGE))) || sys.suspend) {
+        jog_cont.pending = false;
+        return;
+    }
+
+    if(!(sys.state & STATE_JOG) || memcmp(unit_vec, jog_cont.unit_vec, sizeof(jog_cont.unit_vec))) {
+        memcpy(jog_cont.unit_vec, unit_vec, sizeof(jog_cont.unit_vec));
+        memcpy(jog_cont.target, gc_state.position, sizeof(jog_cont.target));
+        jog_cont.remaining_mm = jog_cont.request.max_distance;
+    }
+
+    jog_cont.speed = min(jog_cont.request.speed, limit_value_by_axis_maximum(settings.max_rate, unit_vec));
+    acceleration = limit_value_by_axis_maximum(settings.acceleration, unit_vec);
+
+    // Keep the stopping distance queued, and split it in blocks short enough to fit well within the planner buffer.
+    jog_cont.block_mm = jog_cont.speed * (JOG_CONTINUOUS_BLOCK_TIME / 60000.0f);
+    jog_cont.horizon_mm = jog_cont.speed * jog_cont.speed / (2.0f * acceleration);
+    jog_cont.block_mm = max(jog_cont.block_mm, jog_cont.horizon_mm / (float)(BLOCK_BUFFER_SIZE / 2));
+    jog_cont.horizon_mm += jog_cont.block_mm;
+
+    // Initialize planner data to current spindle and coolant modal state.
+    // NOTE: Spindle and coolant are allowed to fully function with overrides during a jog.
+    memset(&jog_cont.pl_data, 0, sizeof(plan_line_data_t));
+    memcpy(&jog_cont.pl_data.spindle, &gc_state.spindle, sizeof(spindle_t));
+    jog_cont.pl_data.condition.spindle = gc_state.modal.spindle;
+    jog_cont.pl_data.condition.coolant = gc_state.modal.coolant;
+    jog_cont.pl_data.condition.is_rpm_rate_adjusted = gc_state.is_rpm_rate_adjusted;
+    jog_cont.pl_data.condition.no_feed_override = On;
+    jog_cont.pl_data.condition.jog_motion = On;
+    jog_cont.pl_data.line_number = JOG_LINE_NUMBER;
+    jog_cont.pl_data.feed_rate = jog_cont.speed;
+
+    jog_cont.active = jog_cont.pending; // Not if stopped meanwhile.
+    jog_cont.pending = false;
+}
+
+// Stop adding motion for the active continuous jog, the machine decelerates to a stop at the end
+// of the short queue. May be called from an interrupt context.
+void mc_jog_continuous_stop (void)
+{
+    jog_cont.active = jog_cont.pending = false;
+}
+
+// Start a requested continuous jog and extend the active one, called from the main loop between lines
+// so that gc_state.position is not updated while a g-code block is executing.
+void mc_jog_continuous_update (void)
+{
+    if(jog_cont.busy)
+        return;
+
+    if(jog_cont.pending)
+        jog_continuous_start();
+
+    if(!jog_cont.active)
+        return;
+
+    if(sys.suspend || !(sys.state == STATE_IDLE || (sys.state & (STATE_JOG|STATE_TOOL_CHANGE)))) {
+        jog_cont.active = false; // Canceled, aborted or overridden by other motion.
+        return;
+    }
+
+    jog_cont.busy = true; // mc_line() calls protocol_execute_realtime(), block recursion.
+
+    bool last = false;
+    uint_fast8_t idx;
+    float target[N_AXIS], block_mm;
+
+    while(jog_cont.active && !plan_check_full_buffer() && plan_get_buffered_time() * jog_cont.speed < jog_cont.horizon_mm) {
+
+        block_mm = jog_cont.block_mm;
+        if(jog_cont.remaining_mm > 0.0f && (jog_cont.remaining_mm -= block_mm) <= 0.0f) {
+            block_mm += jog_cont.remaining_mm;
+            last = true;
+        }
+
+        idx = N_AXIS;
+        do {
+            idx--;
+            target[idx] = jog_cont.target[idx] + jog_cont.unit_vec[idx] * block_mm;
+        } while(idx);
+
+        // Stop at soft limits.
+        if(settings.limits.flags.jog_soft_limited)
+            system_apply_jog_limits(target);
+        else if (settings.limits.flags.soft_enabled && !system_check_travel_limits(target)) {
+            jog_cont.active = false;
+            break;
+        }
+
+        if(!memcmp(target, jog_cont.target, sizeof(target))) {
+            jog_cont.active = false;
+            break;
+        }
+
+        mc_line(target, &jog_cont.pl_data);
+
+        memcpy(jog_cont.target, target, sizeof(target));
+        memcpy(gc_state.position, target, sizeof(gc_state.position));
+
+        if(last)
+            jog_cont.active = false;
+    }
+
+    if ((sys.state == STATE_IDLE || sys.state == STATE_TOOL_CHANGE) && plan_get_current_block() != NULL) { // Check if there is a block to execute.
+        set_state(STATE_JOG);
+        st_prep_buffer();
+        st_wake_up();  // NOTE: Manual start. No state machine required.
+    }
+
+    jog_cont.busy = false;
+}
+
 // Execute dwell in seconds.
 void mc_dwell (float seconds)
 {
@@ -723,6 +792,31 @@ void mc_dwell (float seconds)
 }
 
 
+// Queue a dwell as a zero motion timed block in the planner buffer. Unlike mc_dwell() the
+// buffer is not drained, motion comes to a stop and continues after the dwell time.
+bool mc_buffered_dwell (float seconds, plan_line_data_t *pl_data)
+{
+    // If in check gcode mode, prevent motion by blocking planner.
+    if (sys.state != STATE_CHECK_MODE && protocol_execute_realtime()) {
+
+        // If the buffer is full: good! That means we are well ahead of the robot.
+        // Remain in this loop until there is room in the buffer.
+        while(plan_check_full_buffer()) {
+            protocol_auto_cycle_start();     // Auto-cycle start when buffer is full.
+            if(!protocol_execute_realtime()) // Check for any run-time commands
+                return false;                // Bail, if system abort.
+        }
+
+        if (sys.cancel)
+            return false;
+
+        plan_buffer_dwell(seconds, pl_data);
+    }
+
+    return !ABORTED;
+}
+
+
 // Perform homing cycle to locate and set machine zero. Only '$H' executes this command.
 // NOTE: There should be no motions in the buffer and Grbl must be in an idle state before
 // executing the homing cycle. This prevents incorrect buffered plans after homing.
@@ -885,13 +979,84 @@ gc_probe_t mc_probe_cycle (float *target, plan_line_data_t *pl_data, gc_parser_f
     plan_sync_position();   // Sync planner position to current machine position.
 
     // All done! Output the probe position as message if configured.
-    if(settings.status_report.probe_coordinates)
+    // NOTE: Probing sequences report the averaged position when completed successfully.
+    if(settings.status_report.probe_coordinates && !(parser_flags.probe_sequence && sys.flags.probe_succeeded))
         report_probe_parameters();
 
     // Successful probe cycle or Failed to trigger probe within travel. With or without error.
     return sys.flags.probe_succeeded ? GCProbe_Found : GCProbe_FailEnd;
 }
 
+#ifdef PROBE_SEQUENCE
+
+// Perform a probing sequence in firmware: a seek probe at the programmed feed rate, then repeatedly
+// backing off by the retract distance and probing again at the latch feed rate. The latch probe
+// positions are averaged and reported as the probe position, the tool is left at the last one.
+// Latch probes travel at most the retract distance beyond the seek probe position.
+gc_probe_t mc_probe_sequence (float *target, plan_line_data_t *pl_data, gc_parser_flags_t parser_flags, float latch_feed_rate, float retract, uint_fast8_t repeats)
+{
+    gc_probe_t status;
+    uint_fast8_t idx, count = 0;
+    float seek_rate = pl_data->feed_rate, unit_vec[N_AXIS], position[N_AXIS], latch_target[N_AXIS], probe_sum[N_AXIS] = {0};
+
+    // Unit vector of the probe direction, from the current position toward the target.
+    idx = N_AXIS;
+    do {
+        idx--;
+        unit_vec[idx] = target[idx] - gc_state.position[idx];
+    } while(idx);
+
+    convert_delta_vector_to_unit_vector(unit_vec);
+
+    if((status = mc_probe_cycle(target, pl_data, parser_flags)) != GCProbe_Found)
+        return status;
+
+    do {
+
+        // Back off from the probe position, opposite to the probe direction.
+        system_convert_array_steps_to_mpos(position, sys_probe_position);
+        idx = N_AXIS;
+        do {
+            idx--;
+            latch_target[idx] = position[idx] + unit_vec[idx] * retract;
+            position[idx] -= unit_vec[idx] * retract;
+        } while(idx);
+
+        pl_data->feed_rate = seek_rate;
+        mc_line(position, pl_data);
+
+        pl_data->feed_rate = latch_feed_rate;
+        if((status = mc_probe_cycle(latch_target, pl_data, parser_flags)) != GCProbe_Found)
+            break;
+
+        idx = N_AXIS;
+        do {
+            idx--;
+            probe_sum[idx] += (float)sys_probe_position[idx];
+        } while(idx);
+
+    } while(++count < repeats);
+
+    pl_data->feed_rate = seek_rate;
+
+    if(status == GCProbe_Found) {
+
+        idx = N_AXIS;
+        do {
+            idx--;
+            sys_probe_position[idx] = lroundf(probe_sum[idx] / (float)count);
+        } while(idx);
+
+        // All done! Output the averaged probe position as message if configured.
+        if(settings.status_report.probe_coordinates)
+            report_probe_parameters();
+    }
+
+    return status;
+}
+
+#endif
+
 
 // Plans and executes the single special motion case for parking. Independent of main planner buffer.
 // NOTE: Uses the always free planner ring buffer head to store motion parameters for execution.
@@ -901,8 +1066,10 @@ bool mc_parking_motion (float *parking_target, plan_line_data_t *pl_data)
         return false; // Block during abort.
 
     if (plan_buffer_line(parking_target, pl_data)) {
+        st_prep_lock(); // sys.step_control is also written by the segment generator, it may run in interrupt context.
         sys.step_control.execute_sys_motion = On;
         sys.step_control.end_motion = Off; // Allow parking motion to execute, if feed hold is active.
+        st_prep_unlock();
         st_parking_setup_buffer(); // Setup step segment buffer for special parking motion case
         st_prep_buffer();
         st_wake_up();
@@ -53,15 +53,28 @@ void mc_thread (plan_line_data_t *pl_data, float *position, gc_thread_data *thre
 // Sets up valid jog motion received from g-code parser, checks for soft-limits, and executes the jog.
 status_code_t mc_jog_execute(plan_line_data_t *pl_data, parser_block_t *gc_block);
 
+// Continuous (velocity mode) jogging for keypads and MPGs, motion is extended while active.
+status_code_t mc_jog_continuous (float *direction, float speed, float max_distance);
+void mc_jog_continuous_update (void);
+void mc_jog_continuous_stop (void);
+
 // Dwell for a specific number of seconds
 void mc_dwell(float seconds);
 
+// Queue a dwell in the planner buffer, does not drain the buffer.
+bool mc_buffered_dwell (float seconds, plan_line_data_t *pl_data);
+
 // Perform homing cycle to locate machine zero. Requires limit switches.
 status_code_t mc_homing_cycle(axes_signals_t cycle);
 
 // Perform tool length probe cycle. Requires probe switch.
 gc_probe_t mc_probe_cycle(float *target, plan_line_data_t *pl_data, gc_parser_flags_t parser_flags);
 
+#ifdef PROBE_SEQUENCE
+// Perform probing sequence, seek probe followed by one or more averaged latch probes at a lower feed rate.
+gc_probe_t mc_probe_sequence(float *target, plan_line_data_t *pl_data, gc_parser_flags_t parser_flags, float latch_feed_rate, float retract, uint_fast8_t repeats);
+#endif
+
 // Handles updating the override control state.
 void mc_override_ctrl_update(gc_override_flags_t override_state);
 
@@ -73,9 +86,4 @@ void mc_cubic_b_spline(float *target, plan_line_data_t *pl_data, float *position
 // Performs system reset. If in motion state, kills all motion and sets system alarm.
 void mc_reset();
 
-#ifdef ENABLE_BACKLASH_COMPENSATION
-void mc_backlash_init (void);
-void mc_sync_backlash_position (void);
-#endif
-
 #endif
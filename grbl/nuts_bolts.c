@@ -224,14 +224,15 @@ void delay_sec (float seconds, delaymode_t mode)
 }
 
 
+// Branch free, zero components add nothing to the magnitude so need no test.
 float convert_delta_vector_to_unit_vector (float *vector)
 {
     uint_fast8_t idx = N_AXIS;
     float magnitude = 0.0f, inv_magnitude;
 
     do {
-        if (vector[--idx] != 0.0f)
-            magnitude += vector[idx] * vector[idx];
+        idx--;
+        magnitude += vector[idx] * vector[idx];
     } while(idx);
 
     idx = N_AXIS;
@@ -246,7 +247,7 @@ float convert_delta_vector_to_unit_vector (float *vector)
 }
 
 
-float limit_value_by_axis_maximum (float *max_value, float *unit_vec)
+float limit_value_by_axis_maximum (const float *max_value, float *unit_vec)
 {
     uint_fast8_t idx = N_AXIS;
     float limit_value = SOME_LARGE_VALUE;
@@ -259,6 +260,23 @@ float limit_value_by_axis_maximum (float *max_value, float *unit_vec)
     return limit_value;
 }
 
+// As limit_value_by_axis_maximum() but with precomputed reciprocals of the maximum values, for use in
+// the planner hot path. min(max_value / |unit_vec|) = 1 / max(|unit_vec| / max_value), branch free
+// and with a single division. Zero components are never selected, no need to test for them.
+float limit_value_by_axis_maximum_inv (const float *inv_max_value, float *unit_vec)
+{
+    uint_fast8_t idx = N_AXIS;
+    float scale = 0.0f, axis_scale;
+
+    do {
+        idx--;
+        axis_scale = fabsf(unit_vec[idx]) * inv_max_value[idx];
+        scale = axis_scale > scale ? axis_scale : scale;
+    } while(idx);
+
+    return scale == 0.0f ? SOME_LARGE_VALUE : 1.0f / scale;
+}
+
 // calculate checksum byte for EEPROM data
 uint8_t calc_checksum (uint8_t *data, uint32_t size) {
 
@@ -160,7 +160,8 @@ bool read_float(char *line, uint_fast8_t *char_counter, float *float_ptr);
 void delay_sec(float seconds, delaymode_t mode);
 
 float convert_delta_vector_to_unit_vector(float *vector);
-float limit_value_by_axis_maximum(float *max_value, float *unit_vec);
+float limit_value_by_axis_maximum(const float *max_value, float *unit_vec);
+float limit_value_by_axis_maximum_inv(const float *inv_max_value, float *unit_vec);
 
 // calculate checksum byte for EEPROM data
 uint8_t calc_checksum (uint8_t *data, uint32_t size);
@@ -29,8 +29,51 @@ static uint_fast8_t block_buffer_head;                  // Index of the next blo
 static uint_fast8_t next_buffer_head;                   // Index of the next buffer head
 static uint_fast8_t block_buffer_planned;               // Index of the optimally planned block
 
+#ifdef SEGMENT_PREP_IRQ
+static uint_fast8_t block_buffer_discarded;             // Index of the first discarded block with memory not yet freed
+#endif
+static uint_fast8_t block_buffer_replan;
+static float buffered_time;                             // Estimated execution time of the queued blocks (min)                // Index of the first block changed by an override, see plan_feed_override()
 static planner_t pl;
 
+// Reciprocals of the axis maximum values, for division free limiting of block acceleration and rate.
+static struct {
+    float acceleration[N_AXIS];
+    float max_rate[N_AXIS];
+} axis_inv;
+
+#ifdef SETTINGS_FROZEN
+
+// Reciprocal of steps/mm, folded at compile time since the settings are frozen.
+static const float mm_per_step[N_AXIS] = {
+    1.0f / DEFAULT_X_STEPS_PER_MM,
+    1.0f / DEFAULT_Y_STEPS_PER_MM,
+    1.0f / DEFAULT_Z_STEPS_PER_MM,
+#ifdef A_AXIS
+    1.0f / DEFAULT_A_STEPS_PER_MM,
+#endif
+#ifdef B_AXIS
+    1.0f / DEFAULT_B_STEPS_PER_MM,
+#endif
+#ifdef C_AXIS
+    1.0f / DEFAULT_C_STEPS_PER_MM,
+#endif
+};
+
+#endif
+
+#ifdef PLANNER_TIME_HORIZON
+
+#define STREAM_RATE_TIMEOUT 500 // ms, input stream considered restarted if no blocks received for this time.
+
+static struct {
+    uint32_t last_ms;   // Time of last rate sample
+    float mm;           // Distance received since last rate sample (mm)
+    float rate;         // Filtered rate of motion delivered by the input stream (mm/min), 0 if unknown
+} stream;
+
+#endif
+
 // Returns the index of the next block in the ring buffer. Also called by stepper segment buffer.
 inline static uint_fast8_t plan_next_block_index (uint_fast8_t block_index)
 {
@@ -45,6 +88,42 @@ inline static uint_fast8_t plan_prev_block_index (uint_fast8_t block_index)
 }
 
 
+// Forward Pass: Forward plan the acceleration curve from the planned pointer onward.
+// Also scans for optimal plan breakpoints and appropriately updates the planned pointer.
+static void planner_forward_pass (void)
+{
+    float entry_speed_sqr;
+    plan_block_t *current, *next = &block_buffer[block_buffer_planned]; // Begin at buffer planned pointer
+    uint_fast8_t block_index = plan_next_block_index(block_buffer_planned);
+
+    while (block_index != block_buffer_head) {
+
+        current = next;
+        next = &block_buffer[block_index];
+
+        // Any acceleration detected in the forward pass automatically moves the optimal planned
+        // pointer forward, since everything before this is all optimal. In other words, nothing
+        // can improve the plan from the buffer tail to the planned pointer by logic.
+        if (current->entry_speed_sqr < next->entry_speed_sqr) {
+            entry_speed_sqr = current->entry_speed_sqr + 2.0f * current->acceleration * current->millimeters;
+        // If true, current block is full-acceleration and we can move the planned pointer forward.
+            if (entry_speed_sqr < next->entry_speed_sqr) {
+                next->entry_speed_sqr = entry_speed_sqr; // Always <= max_entry_speed_sqr. Backward pass sets this.
+                block_buffer_planned = block_index; // Set optimal plan pointer.
+            }
+        }
+
+        // Any block set at its maximum entry speed also creates an optimal plan up to this
+        // point in the buffer. When the plan is bracketed by either the beginning of the
+        // buffer and a maximum entry speed or two maximum entry speeds, every block in between
+        // cannot logically be further improved. Hence, we don't have to recompute them anymore.
+        if (next->entry_speed_sqr == next->max_entry_speed_sqr)
+            block_buffer_planned = block_index;
+
+        block_index = plan_next_block_index(block_index);
+    }
+}
+
 /*                            PLANNER SPEED DEFINITION
                                      +--------+   <- current->nominal_speed
                                     /          \
@@ -151,37 +230,7 @@ static void planner_recalculate ()
         }
     }
 
-    // Forward Pass: Forward plan the acceleration curve from the planned pointer onward.
-    // Also scans for optimal plan breakpoints and appropriately updates the planned pointer.
-    next = &block_buffer[block_buffer_planned]; // Begin at buffer planned pointer
-    block_index = plan_next_block_index(block_buffer_planned);
-
-    while (block_index != block_buffer_head) {
-
-        current = next;
-        next = &block_buffer[block_index];
-
-        // Any acceleration detected in the forward pass automatically moves the optimal planned
-        // pointer forward, since everything before this is all optimal. In other words, nothing
-        // can improve the plan from the buffer tail to the planned pointer by logic.
-        if (current->entry_speed_sqr < next->entry_speed_sqr) {
-            entry_speed_sqr = current->entry_speed_sqr + 2.0f * current->acceleration * current->millimeters;
-        // If true, current block is full-acceleration and we can move the planned pointer forward.
-            if (entry_speed_sqr < next->entry_speed_sqr) {
-                next->entry_speed_sqr = entry_speed_sqr; // Always <= max_entry_speed_sqr. Backward pass sets this.
-                block_buffer_planned = block_index; // Set optimal plan pointer.
-            }
-        }
-
-        // Any block set at its maximum entry speed also creates an optimal plan up to this
-        // point in the buffer. When the plan is bracketed by either the beginning of the
-        // buffer and a maximum entry speed or two maximum entry speeds, every block in between
-        // cannot logically be further improved. Hence, we don't have to recompute them anymore.
-        if (next->entry_speed_sqr == next->max_entry_speed_sqr)
-            block_buffer_planned = block_index;
-
-        block_index = plan_next_block_index(block_index);
-    }
+    planner_forward_pass();
 }
 
 inline static void plan_cleanup (plan_block_t *block)
@@ -196,6 +245,13 @@ inline static void plan_cleanup (plan_block_t *block)
         free(block->output_commands);
         block->output_commands = next;
     }
+
+#ifdef LASER_RASTER_MODE
+    if(block->raster) {
+        free(block->raster);
+        block->raster = NULL;
+    }
+#endif
 }
 
 
@@ -209,31 +265,70 @@ inline static void plan_reset_buffer (bool soft_reset)
     block_buffer_head = 0;      // Empty = tail
     next_buffer_head = 1;       // plan_next_block_index(block_buffer_head)
     block_buffer_planned = 0;   // = block_buffer_tail;
+    buffered_time = 0.0f;
+#ifdef SEGMENT_PREP_IRQ
+    block_buffer_discarded = 0; // = block_buffer_tail;
+#endif
 }
 
 
 void plan_reset ()
 {
     static bool soft_reset = false;
+    st_prep_lock();
     memset(&pl, 0, sizeof(planner_t)); // Clear planner struct
     plan_reset_buffer(soft_reset);
+    st_prep_unlock();
+    plan_axis_limits_init();
     soft_reset = true;
 }
 
 
+void plan_axis_limits_init ()
+{
+    uint_fast8_t idx = N_AXIS;
+
+    do {
+        idx--;
+        axis_inv.acceleration[idx] = 1.0f / settings.acceleration[idx];
+        axis_inv.max_rate[idx] = 1.0f / settings.max_rate[idx];
+    } while(idx);
+}
+
+
 void plan_discard_current_block ()
 {
     if (block_buffer_head != block_buffer_tail) { // Discard non-empty buffer.
         uint_fast8_t block_index = plan_next_block_index(block_buffer_tail);
+      #ifndef SEGMENT_PREP_IRQ // Called by the segment generator, memory is freed by plan_free_discarded() in the foreground.
         plan_cleanup(&block_buffer[block_buffer_tail]);
+      #endif
         // Push block_buffer_planned pointer, if encountered.
         if (block_buffer_tail == block_buffer_planned)
             block_buffer_planned = block_index;
+        // Reset when empty, rounding errors are otherwise accumulated.
+        buffered_time = block_index == block_buffer_head ? 0.0f : buffered_time - block_buffer[block_buffer_tail].time;
         block_buffer_tail = block_index;
     }
 }
 
 
+#ifdef SEGMENT_PREP_IRQ
+
+void plan_free_discarded (void)
+{
+    st_prep_lock();
+
+    while(block_buffer_discarded != block_buffer_tail) {
+        plan_cleanup(&block_buffer[block_buffer_discarded]);
+        block_buffer_discarded = plan_next_block_index(block_buffer_discarded);
+    }
+
+    st_prep_unlock();
+}
+
+#endif
+
 // Returns address of planner buffer block used by system motions. Called by segment generator.
 plan_block_t *plan_get_system_motion_block ()
 {
@@ -266,6 +361,9 @@ bool plan_check_full_buffer ()
 // NOTE: All system motion commands, such as homing/parking, are not subject to overrides.
 float plan_compute_profile_nominal_speed (plan_block_t *block)
 {
+    if(block->condition.dwell)
+        return 0.0f; // Enforces stop before and after the dwell.
+
     float nominal_speed = block->condition.spindle.synchronized ? block->programmed_rate * hal.spindle_get_data(SpindleData_RPM).rpm : block->programmed_rate;
 
     if (block->condition.rapid_motion)
@@ -282,6 +380,12 @@ float plan_compute_profile_nominal_speed (plan_block_t *block)
 }
 
 
+// Returns the estimated execution time of the block in minutes.
+inline static float plan_get_block_time (plan_block_t *block)
+{
+    return block->condition.dwell ? block->dwell : block->millimeters / plan_compute_profile_nominal_speed(block);
+}
+
 // Computes and updates the max entry speed (sqr) of the block, based on the minimum of the junction's
 // previous and current nominal speeds and max junction speed.
 inline static float plan_compute_profile_parameters (plan_block_t *block, float nominal_speed, float prev_nominal_speed)
@@ -294,20 +398,104 @@ inline static float plan_compute_profile_parameters (plan_block_t *block, float
 }
 
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
-void plan_update_velocity_profile_parameters ()
+// Only blocks subject to the changed override(s) and the blocks following them, sharing a junction,
+// are recomputed. The max junction speed, acceleration and length are independent of overrides and kept.
+// Returns true if the nominal speed of any buffered block is subject to the changed override(s),
+// if not the current plan is still valid and replanning can be skipped.
+bool plan_update_velocity_profile_parameters (bool feed_changed, bool rapid_changed)
 {
-    uint_fast8_t block_index = block_buffer_tail;
-    plan_block_t *block;
+    bool affected, prev_affected = false, found = false;
+    uint_fast8_t block_index;
+    plan_block_t *block, *prev_block = NULL;
     float prev_nominal_speed = SOME_LARGE_VALUE; // Set high for first block nominal speed calculation.
 
+    st_prep_lock();
+
+    block_index = block_buffer_tail;
+
     while (block_index != block_buffer_head) {
         block = &block_buffer[block_index];
-        prev_nominal_speed = plan_compute_profile_parameters(block, plan_compute_profile_nominal_speed(block), prev_nominal_speed);
+        affected = !block->condition.dwell && (block->condition.rapid_motion ? rapid_changed : (feed_changed && !block->condition.no_feed_override));
+        if(affected || prev_affected) {
+            if(!found) {
+                found = true;
+                block_buffer_replan = block_index; // First block with a changed max entry speed.
+            }
+            if(!prev_affected && prev_block)
+                prev_nominal_speed = plan_compute_profile_nominal_speed(prev_block);
+            prev_nominal_speed = plan_compute_profile_parameters(block, plan_compute_profile_nominal_speed(block), prev_nominal_speed);
+            if(affected) {
+                buffered_time -= block->time;
+                block->time = block->millimeters / prev_nominal_speed;
+                buffered_time += block->time;
+            }
+        }
+        prev_affected = affected;
+        prev_block = block;
+        block_index = plan_next_block_index(block_index);
+    }
+
+    if(prev_affected)
+        pl.previous_nominal_speed = prev_nominal_speed; // Update prev nominal speed for next incoming block.
+
+    st_prep_unlock();
+
+    return found;
+}
+
+
+#ifdef PLANNER_TIME_HORIZON
+
+// Updates the estimate of the rate motion is delivered to the planner by the input stream.
+static void plan_update_stream_rate (float millimeters)
+{
+    if(hal.get_elapsed_ticks) {
+
+        uint32_t ms = hal.get_elapsed_ticks(), dt = ms - stream.last_ms;
+
+        stream.mm += millimeters;
+
+        if(dt > STREAM_RATE_TIMEOUT) {
+            stream.rate = stream.mm = 0.0f; // Stream (re)started, rate unknown.
+            stream.last_ms = ms;
+        } else if(dt) {
+            float rate = stream.mm * 60000.0f / (float)dt;
+            stream.rate = stream.rate == 0.0f ? rate : stream.rate + 0.25f * (rate - stream.rate);
+            stream.mm = 0.0f;
+            stream.last_ms = ms;
+        }
+    }
+}
+
+// Caps the nominal speed of a new block if the motion buffered in the planner will be executed
+// in less time than the time horizon, so that the machine slows down instead of stopping when
+// the input stream cannot keep up. NOTE: The new block is at the buffer head, not yet added.
+static void plan_limit_starving_block (plan_block_t *block)
+{
+    float millimeters = block->millimeters, nominal_speed = plan_compute_profile_nominal_speed(block);
+    float time = millimeters / nominal_speed;
+    uint_fast8_t block_index = block_buffer_tail;
+
+    while (block_index != block_buffer_head) {
+        millimeters += block_buffer[block_index].millimeters;
+        time += plan_get_block_time(&block_buffer[block_index]);
         block_index = plan_next_block_index(block_index);
     }
-    pl.previous_nominal_speed = prev_nominal_speed; // Update prev nominal speed for next incoming block.
+
+    if(time < (PLANNER_TIME_HORIZON / 60000.0f)) {
+        // Sustainable speed is the larger of the rate the stream delivers and what drains the buffer in the horizon time.
+        float max_speed = max(millimeters * (60000.0f / PLANNER_TIME_HORIZON), stream.rate);
+        if(max_speed < nominal_speed) {
+            max_speed = max(max_speed, MINIMUM_FEED_RATE);
+            if(block->condition.rapid_motion)
+                block->programmed_rate *= max_speed / nominal_speed;
+            else
+                block->rapid_rate = max_speed; // Caps feed rate, also when overridden.
+        }
+    }
 }
 
+#endif
 
 /* Add a new linear movement to the buffer. target[N_AXIS] is the signed, absolute target position
    in millimeters. Feed rate specifies the speed of the motion. If feed rate is inverted, the feed
@@ -331,6 +519,12 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
     uint_fast8_t idx;
     float unit_vec[N_AXIS];
 
+    st_prep_lock(); // The block at the buffer head is used by the segment generator for system motions.
+
+#ifdef SEGMENT_PREP_IRQ
+    plan_free_discarded(); // The block at the buffer head may be discarded but not yet freed.
+#endif
+
     memset(block, 0, sizeof(plan_block_t));                         // Zero all block values.
     memcpy(&block->spindle, &pl_data->spindle, sizeof(spindle_t));  // Copy spindle data (RPM etc)
     block->condition = pl_data->condition;
@@ -338,6 +532,9 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
     block->line_number = pl_data->line_number;
     block->message = pl_data->message;
     block->output_commands = pl_data->output_commands;
+#ifdef LASER_RASTER_MODE
+    block->raster = pl_data->raster;
+#endif
 
     // Copy position data based on type of motion being planned.
     memcpy(position_steps, block->condition.system_motion ? sys_position : pl.position, sizeof(position_steps));
@@ -346,6 +543,11 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
 
 #ifdef KINEMATICS_API
     kinematics.plan_target_to_steps(target_steps, target);
+    // If supported keep non-linear motions as a single block in cartesian space, the segment generator
+    // converts the end position of each step segment to motor steps.
+    block->condition.cartesian_motion = kinematics.segment_target_to_steps != NULL &&
+                                         !(block->condition.system_motion || block->condition.spindle.synchronized) &&
+                                          memcmp(target, pl.position_mm, sizeof(pl.position_mm)); // Zero length in cartesian space?
 #endif
 
     idx = N_AXIS;
@@ -361,7 +563,11 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
         delta_steps = target_steps[idx] - position_steps[idx];
         block->steps[idx] = labs(delta_steps);
         block->step_event_count = max(block->step_event_count, block->steps[idx]);
+#ifdef SETTINGS_FROZEN
+        unit_vec[idx] = (float)delta_steps * mm_per_step[idx]; // Store unit vector numerator
+#else
         unit_vec[idx] = (float)delta_steps / settings.steps_per_mm[idx]; // Store unit vector numerator
+#endif
 
         // Set direction bits. Bit enabled always means direction is negative.
         if (delta_steps < 0)
@@ -369,10 +575,27 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
 
     } while(idx);
 
+#ifdef KINEMATICS_API
+    if(block->condition.cartesian_motion) {
+        // Plan cartesian blocks by their distance and direction in cartesian space.
+        idx = N_AXIS;
+        do {
+            idx--;
+            unit_vec[idx] = target[idx] - pl.position_mm[idx];
+        } while(idx);
+        memcpy(block->cartesian_start, pl.position_mm, sizeof(block->cartesian_start));
+        memcpy(block->cartesian_target, target, sizeof(block->cartesian_target));
+    }
+#endif
+
     // Calculate RPMs to be used for Constant Surface Speed calculations
     if(block->condition.is_rpm_pos_adjusted) {
         float pos;
+#ifdef SETTINGS_FROZEN
+        if((pos = (float)position_steps[block->spindle.css.axis] * mm_per_step[block->spindle.css.axis] - block->spindle.css.tool_offset) > 0.0f) {
+#else
         if((pos = (float)position_steps[block->spindle.css.axis] / settings.steps_per_mm[block->spindle.css.axis] - block->spindle.css.tool_offset) > 0.0f) {
+#endif
             block->spindle.rpm = block->spindle.css.surface_speed / (pos * (float)(2.0f * M_PI));
             if(block->spindle.rpm > block->spindle.css.max_rpm)
                 block->spindle.rpm = block->spindle.css.max_rpm;
@@ -387,19 +610,24 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
     }
 
     // Bail if this is a zero-length block. Highly unlikely to occur.
-    if (block->step_event_count == 0)
+    if (block->step_event_count == 0) {
+        st_prep_unlock();
         return false;
+    }
 
     pl_data->message = NULL;         // Indicate message is already queued for display on execution
     pl_data->output_commands = NULL; // Indicate commands are already queued for execution
+#ifdef LASER_RASTER_MODE
+    pl_data->raster = NULL;          // Indicate scanline is already queued for execution
+#endif
 
     // Calculate the unit vector of the line move and the block maximum feed rate and acceleration scaled
     // down such that no individual axes maximum values are exceeded with respect to the line direction.
     // NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
     // if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
     block->millimeters = convert_delta_vector_to_unit_vector(unit_vec);
-    block->acceleration = limit_value_by_axis_maximum(settings.acceleration, unit_vec);
-    block->rapid_rate = limit_value_by_axis_maximum(settings.max_rate, unit_vec);
+    block->acceleration = limit_value_by_axis_maximum_inv(axis_inv.acceleration, unit_vec);
+    block->rapid_rate = limit_value_by_axis_maximum_inv(axis_inv.max_rate, unit_vec);
 
     // Store programmed rate.
     if (block->condition.rapid_motion)
@@ -452,8 +680,23 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
             junction_unit_vec[idx] = unit_vec[idx] - pl.previous_unit_vec[idx];
         } while(idx);
 
+        if (pl_data->arc_radius > 0.0f) {
+            // Junction between segments of an arc. Limit speed by centripetal acceleration at the true arc
+            // radius, v^2 = a * r, where a is the lowest acceleration of the axes changing direction.
+            float junction_acceleration = SOME_LARGE_VALUE;
+            idx = N_AXIS;
+            do {
+                idx--;
+                junction_acceleration = junction_unit_vec[idx] != 0.0f && settings.acceleration[idx] < junction_acceleration
+                                         ? settings.acceleration[idx]
+                                         : junction_acceleration;
+            } while(idx);
+            block->max_junction_speed_sqr = junction_acceleration == SOME_LARGE_VALUE
+                                             ? SOME_LARGE_VALUE
+                                             : max(MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED, junction_acceleration * pl_data->arc_radius);
+        }
         // NOTE: Computed without any expensive trig, sin() or acos(), by trig half angle identity of cos(theta).
-        if (junction_cos_theta > 0.999999f)
+        else if (junction_cos_theta > 0.999999f)
             //  For a 0 degree acute junction, just set minimum junction speed.
             block->max_junction_speed_sqr = MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED;
         else if (junction_cos_theta < -0.999999f) {
@@ -461,7 +704,7 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
             block->max_junction_speed_sqr = SOME_LARGE_VALUE;
         } else {
             convert_delta_vector_to_unit_vector(junction_unit_vec);
-            float junction_acceleration = limit_value_by_axis_maximum(settings.acceleration, junction_unit_vec);
+            float junction_acceleration = limit_value_by_axis_maximum_inv(axis_inv.acceleration, junction_unit_vec);
             float sin_theta_d2 = sqrtf(0.5f * (1.0f - junction_cos_theta)); // Trig half angle identity. Always positive.
             block->max_junction_speed_sqr = max(MINIMUM_JUNCTION_SPEED * MINIMUM_JUNCTION_SPEED,
                                                   (junction_acceleration * settings.junction_deviation * sin_theta_d2) / (1.0f - sin_theta_d2));
@@ -471,13 +714,25 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
     // Block system motion from updating this data to ensure next g-code motion is computed correctly.
     if (!block->condition.system_motion) {
 
+      #ifdef PLANNER_TIME_HORIZON
+        plan_update_stream_rate(block->millimeters);
+        // Only limit blocks added while in a cycle when the input stream does not keep the buffer full.
+        if(sys.state == STATE_CYCLE && plan_get_block_buffer_available() > 1 &&
+            !(block->condition.jog_motion || block->condition.inverse_time || block->condition.spindle.synchronized))
+            plan_limit_starving_block(block);
+      #endif
+
         pl.previous_nominal_speed = plan_compute_profile_parameters(block, plan_compute_profile_nominal_speed(block), pl.previous_nominal_speed);
 
-        if(!block->condition.backlash_motion) {
-            // Update previous path unit_vector and planner position.
-            memcpy(pl.previous_unit_vec, unit_vec, sizeof(unit_vec)); // pl.previous_unit_vec[] = unit_vec[]
-            memcpy(pl.position, target_steps, sizeof(target_steps)); // pl.position[] = target_steps[]
-        }
+        // Update previous path unit_vector and planner position.
+        memcpy(pl.previous_unit_vec, unit_vec, sizeof(unit_vec)); // pl.previous_unit_vec[] = unit_vec[]
+        memcpy(pl.position, target_steps, sizeof(target_steps)); // pl.position[] = target_steps[]
+#ifdef KINEMATICS_API
+        memcpy(pl.position_mm, target, sizeof(pl.position_mm));
+#endif
+        block->time = plan_get_block_time(block);
+        buffered_time += block->time;
+
         // New block is all set. Update buffer head and next buffer head indices.
         block_buffer_head = next_buffer_head;
         next_buffer_head = plan_next_block_index(block_buffer_head);
@@ -486,14 +741,60 @@ bool plan_buffer_line (float *target, plan_line_data_t *pl_data)
         planner_recalculate();
     }
 
+    st_prep_unlock();
+
     return true;
 }
 
 
+// Add a dwell to the buffer. The dwell block has zero nominal speed, forcing a stop before and after it.
+// NOTE: Assumes buffer is available. Buffer checks are handled at a higher level by motion_control.
+void plan_buffer_dwell (float seconds, plan_line_data_t *pl_data)
+{
+    plan_block_t *block = &block_buffer[block_buffer_head];
+
+    st_prep_lock();
+
+#ifdef SEGMENT_PREP_IRQ
+    plan_free_discarded();
+#endif
+
+    memset(block, 0, sizeof(plan_block_t));                         // Zero all block values.
+    memcpy(&block->spindle, &pl_data->spindle, sizeof(spindle_t));  // Copy spindle data (RPM etc)
+    block->condition = pl_data->condition;
+    block->condition.dwell = On;
+    block->overrides = pl_data->overrides;
+    block->line_number = pl_data->line_number;
+    block->message = pl_data->message;
+    block->output_commands = pl_data->output_commands;
+    block->dwell = seconds / 60.0f;
+
+    pl_data->message = NULL;         // Indicate message is already queued for display on execution
+    pl_data->output_commands = NULL; // Indicate commands are already queued for execution
+
+    pl.previous_nominal_speed = plan_compute_profile_parameters(block, plan_compute_profile_nominal_speed(block), pl.previous_nominal_speed);
+
+    block->time = block->dwell;
+    buffered_time += block->time;
+
+    // New block is all set. Update buffer head and next buffer head indices.
+    block_buffer_head = next_buffer_head;
+    next_buffer_head = plan_next_block_index(block_buffer_head);
+
+    // Finish up by recalculating the plan with the new block.
+    planner_recalculate();
+
+    st_prep_unlock();
+}
+
+
 // Reset the planner position vectors. Called by the system abort/initialization routine.
 void plan_sync_position ()
 {
     memcpy(pl.position, sys_position, sizeof(pl.position));
+#ifdef KINEMATICS_API
+    system_convert_array_steps_to_mpos(pl.position_mm, sys_position);
+#endif
 }
 
 
@@ -504,14 +805,82 @@ uint8_t plan_get_block_buffer_available ()
 }
 
 
+// Returns the planner position, the end of the last queued motion, in machine coordinates (mm).
+void plan_get_planner_mpos (float *target)
+{
+    system_convert_array_steps_to_mpos(target, pl.position);
+}
+
+
+// Returns the estimated execution time of the queued planner blocks in minutes, based on nominal speeds.
+// The running total is updated when blocks are added, overridden or discarded.
+// NOTE: Acceleration is not accounted for and the executing block is counted in full.
+//       The spindle speed of spindle synchronized motions is sampled when queued.
+float plan_get_buffered_time ()
+{
+    return buffered_time;
+}
+
+
 // Re-initialize buffer plan with a partially completed block, assumed to exist at the buffer tail.
 // Called after a steppers have come to a complete stop for a feed hold and the cycle is stopped.
 void plan_cycle_reinitialize ()
 {
     // Re-plan from a complete stop. Reset planner entry speeds and buffer planned pointer.
+    st_prep_lock();
     st_update_plan_block_parameters();
     block_buffer_planned = block_buffer_tail;
     planner_recalculate();
+    st_prep_unlock();
+}
+
+// Re-plans after an override change, see plan_update_velocity_profile_parameters(). Blocks ahead of
+// the first changed block keep their plan up to the last block that stays at its max entry speed, since
+// a lower entry speed can propagate back from the changed blocks. Falls back to a full re-plan from
+// the executing block if it is changed itself or the change propagates back to it.
+static void plan_cycle_replan (void)
+{
+    if(block_buffer_replan == block_buffer_tail) {
+        plan_cycle_reinitialize();
+        return;
+    }
+
+    st_prep_lock();
+
+    bool ahead = false;
+    float entry_speed_sqr;
+    uint_fast8_t block_index = plan_prev_block_index(block_buffer_head);
+    plan_block_t *next, *current = &block_buffer[block_index];
+
+    // Reverse Pass: the exit speed of the last block is always zero.
+    current->entry_speed_sqr = min(current->max_entry_speed_sqr, 2.0f * current->acceleration * current->millimeters);
+
+    while(true) {
+
+        ahead = ahead || block_index == block_buffer_replan;
+        next = current;
+        block_index = plan_prev_block_index(block_index);
+
+        if(block_index == block_buffer_tail) { // Reached the executing block, notify stepper to update its current parameters.
+            st_update_plan_block_parameters();
+            break;
+        }
+
+        current = &block_buffer[block_index];
+        entry_speed_sqr = next->entry_speed_sqr + 2.0f * current->acceleration * current->millimeters;
+
+        // A block ahead of the changed blocks that was and still is at its max entry speed brackets
+        // the part of the plan that is unchanged.
+        if(ahead && current->entry_speed_sqr == current->max_entry_speed_sqr && entry_speed_sqr >= current->max_entry_speed_sqr)
+            break;
+
+        current->entry_speed_sqr = entry_speed_sqr < current->max_entry_speed_sqr ? entry_speed_sqr : current->max_entry_speed_sqr;
+    }
+
+    block_buffer_planned = block_index;
+    planner_forward_pass();
+
+    st_prep_unlock();
 }
 
 // Set feed overrides
@@ -522,11 +891,15 @@ void plan_feed_override (uint_fast8_t feed_override, uint_fast8_t rapid_override
 
     feed_override = max(min(feed_override, MAX_FEED_RATE_OVERRIDE), MIN_FEED_RATE_OVERRIDE);
 
-    if ((feed_override != sys.override.feed_rate) || (rapid_override != sys.override.rapid_rate)) {
+    bool feed_changed = feed_override != sys.override.feed_rate,
+         rapid_changed = rapid_override != sys.override.rapid_rate;
+
+    if (feed_changed || rapid_changed) {
       sys.override.feed_rate = (uint8_t)feed_override;
       sys.override.rapid_rate = (uint8_t)rapid_override;
       sys.report.overrides = On; // Set to report change immediately
-      plan_update_velocity_profile_parameters();
-      plan_cycle_reinitialize();
+      // Only replan if there are buffered motions that are subject to the changed override(s).
+      if(plan_update_velocity_profile_parameters(feed_changed, rapid_changed))
+          plan_cycle_replan();
     }
 }
@@ -34,18 +34,38 @@ typedef union {
         uint16_t rapid_motion         :1,
                  system_motion        :1,
                  jog_motion           :1,
-                 backlash_motion      :1,
                  no_feed_override     :1,
                  inverse_time         :1,
                  is_rpm_rate_adjusted :1,
                  is_rpm_pos_adjusted  :1,
                  is_laser_ppi_mode    :1,
-                 unassigned           :7;
+                 cartesian_motion     :1, // Non-linear kinematics, converted to motor steps by the segment generator.
+                 dwell                :1, // Zero motion timed block.
+                 unassigned           :6;
         spindle_state_t spindle;
         coolant_state_t coolant;
     };
 } planner_cond_t;
 
+#ifdef LASER_RASTER_MODE
+
+// Laser raster scanline, executed as a single line motion with the laser power set per pixel by the stepper ISR.
+typedef struct laser_raster {
+#ifdef SEGMENT_PREP_IRQ
+    struct laser_raster *next;  // Link in the list of scanlines released by the segment generator.
+#endif
+    uint_fast16_t length;       // Number of pixels
+    uint_fast8_t axis;          // Axis tracking pixel boundaries, the axis with most steps. Set by the segment generator.
+    uint32_t pixel_steps;       // Axis steps per pixel in 24.8 fixed point format. Set by the segment generator.
+#ifdef SPINDLE_PWM_DIRECT
+    uint_fast16_t power[];      // Pixel values (0 - 63), converted to PWM values by the segment generator.
+#else
+    float power[];              // Pixel values (0 - 63), converted to RPM by the segment generator.
+#endif
+} laser_raster_t;
+
+#endif
+
 // This struct stores a linear movement of a g-code block motion with its critical "nominal" values
 // are as specified in the source g-code.
 typedef struct {
@@ -73,12 +93,24 @@ typedef struct {
     float max_junction_speed_sqr; // Junction entry speed limit based on direction vectors in (mm/min)^2
     float rapid_rate;             // Axis-limit adjusted maximum rate for this block direction in (mm/min)
     float programmed_rate;        // Programmed rate of this block (mm/min).
+    float dwell;                  // Remaining dwell time of a dwell block (min).
+                                  // NOTE: This value is altered by stepper algorithm during execution.
+    float time;                   // Estimated execution time when queued or overridden (min), see plan_get_buffered_time().
 
     // Stored spindle speed data used by spindle overrides and resuming methods.
     spindle_t spindle;    // Block spindle speed. Copied from pl_line_data.
 
     char *message;                // Message to be displayed when block is executed.
     output_command_t *output_commands;
+#ifdef LASER_RASTER_MODE
+    laser_raster_t *raster;       // Scanline pixels, handed over to the stepper block when prepped.
+#endif
+
+#ifdef KINEMATICS_API
+    // Start and end position in cartesian space (mm), used by the segment generator for cartesian_motion blocks.
+    float cartesian_start[N_AXIS];
+    float cartesian_target[N_AXIS];
+#endif
 } plan_block_t;
 
 
@@ -89,9 +121,13 @@ typedef struct {
     planner_cond_t condition;       // Bitfield variable to indicate planner conditions. See defines above.
     gc_override_flags_t overrides;  // Block bitfield variable for overrides
     int32_t line_number;            // Desired line number to report when executing.
+    float arc_radius;               // Radius of arc the motion is a segment of, 0 for the first segment and non-arc motions.
 //    void *parameters;               // TODO: pointer to extra parameters, for canned cycles and threading?
     char *message;                  // Message to be displayed when block is executed.
     output_command_t *output_commands;
+#ifdef LASER_RASTER_MODE
+    laser_raster_t *raster;         // Scanline pixels, NULL for ordinary line motions.
+#endif
 } plan_line_data_t;
 
 
@@ -99,13 +135,19 @@ typedef struct {
 typedef struct {
   int32_t position[N_AXIS];         // The planner position of the tool in absolute steps. Kept separate
                                     // from g-code position for movements requiring multiple line motions,
-                                    // i.e. arcs, canned cycles, and backlash compensation.
+                                    // i.e. arcs and canned cycles.
   float previous_unit_vec[N_AXIS];  // Unit vector of previous path line segment
   float previous_nominal_speed;     // Nominal speed of previous path line segment
+#ifdef KINEMATICS_API
+  float position_mm[N_AXIS];        // The planner position of the tool in cartesian space (mm).
+#endif
 } planner_t;
 
 // Initialize and reset the motion plan subsystem
 void plan_reset(); // Reset all
+
+// Precompute the reciprocals of the axis acceleration and max rate settings. Called on settings changes.
+void plan_axis_limits_init();
 //void plan_reset_buffer(); // Reset buffer only.
 
 // Add a new linear movement to the buffer. target[N_AXIS] is the signed, absolute target position
@@ -113,10 +155,20 @@ void plan_reset(); // Reset all
 // rate is taken to mean "frequency" and would complete the operation in 1/feed_rate minutes.
 bool plan_buffer_line(float *target, plan_line_data_t *pl_data);
 
+// Add a dwell, a zero motion timed block, to the buffer. Motion comes to a stop before the dwell
+// and restarts from rest after it, without the need for draining the buffer.
+void plan_buffer_dwell (float seconds, plan_line_data_t *pl_data);
+
 // Called when the current block is no longer needed. Discards the block and makes the memory
 // availible for new blocks.
 void plan_discard_current_block();
 
+#ifdef SEGMENT_PREP_IRQ
+// Frees memory of discarded blocks, deferred by plan_discard_current_block() since the segment
+// generator may run in interrupt context. Foreground only.
+void plan_free_discarded (void);
+#endif
+
 // Gets the planner block for the special system motion cases. (Parking/Homing)
 plan_block_t *plan_get_system_motion_block();
 
@@ -130,7 +182,8 @@ float plan_get_exec_block_exit_speed_sqr();
 float plan_compute_profile_nominal_speed(plan_block_t *block);
 
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
-void plan_update_velocity_profile_parameters();
+// Returns true if any buffered motion is affected by the change.
+bool plan_update_velocity_profile_parameters(bool feed_changed, bool rapid_changed);
 
 // Reset the planner position vector (in steps)
 void plan_sync_position();
@@ -141,6 +194,9 @@ void plan_cycle_reinitialize();
 // Returns the number of available blocks in the planner buffer.
 uint8_t plan_get_block_buffer_available();
 
+// Returns the estimated execution time of the queued planner blocks in minutes.
+float plan_get_buffered_time();
+
 // Returns the status of the block ring buffer. True, if buffer is full.
 bool plan_check_full_buffer();
 
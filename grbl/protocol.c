@@ -47,8 +47,58 @@ static char xcommand[LINE_BUFFER_SIZE];
 static bool keep_rt_commands = false;
 static user_message_t user_message = {NULL, 0, 0, false};
 static const char *msg = "(MSG,";
+static uint_fast16_t pending_reports = 0;
 static void protocol_exec_rt_suspend();
 
+// Driver polling, e.g. native USB stream input and keypads.
+static void poll_task (uint_fast16_t state)
+{
+    if(hal.execute_realtime)
+        hal.execute_realtime(state);
+}
+
+static task_t driver_task = {
+    .execute = poll_task,
+    .priority = TaskPriority_High,
+    .period = 0,
+    .budget = 1
+};
+
+// Plugin polling.
+static void plugin_poll_task (uint_fast16_t state)
+{
+    hooks_dispatch(execute_realtime, state);
+}
+
+static task_t plugin_task = {
+    .execute = plugin_poll_task,
+    .priority = TaskPriority_Normal,
+    .period = 0,
+    .budget = 1
+};
+
+// Multi line reports, output after the segment buffer has been topped up.
+static void report_task (uint_fast16_t state)
+{
+    uint_fast16_t reports = pending_reports;
+
+    pending_reports = 0;
+
+    if(reports & EXEC_GCODE_REPORT)
+        report_gcode_modes();
+
+    // Print PID log to output stream
+    if(reports & EXEC_PID_REPORT)
+        report_pid_log();
+}
+
+static task_t reports_task = {
+    .execute = report_task,
+    .priority = TaskPriority_Normal,
+    .period = 0,
+    .budget = 2
+};
+
 // add gcode to execute not originating from normal input stream
 bool protocol_enqueue_gcode (char *gcode)
 {
@@ -70,6 +120,12 @@ bool protocol_enqueue_gcode (char *gcode)
 */
 bool protocol_main_loop(bool cold_start)
 {
+    if(cold_start) {
+        task_register(&driver_task);
+        task_register(&plugin_task);
+        task_register(&reports_task);
+    }
+
     if (hal.system_control_get_state().e_stop) {
         // Check for e-stop active. Blocks everything until cleared.
         set_state(STATE_ESTOP);
@@ -104,7 +160,7 @@ bool protocol_main_loop(bool cold_start)
 #ifdef ENABLE_SAFETY_DOOR_INPUT_PIN
         // Check if the safety door is open.
         if (!settings.flags.safety_door_ignore_when_idle && hal.system_control_get_state().safety_door_ajar) {
-            bit_true(sys_rt_exec_state, EXEC_SAFETY_DOOR);
+            system_set_exec_state_flag(EXEC_SAFETY_DOOR);
             protocol_execute_realtime(); // Enter safety door mode. Should return as IDLE state.
         }
 #endif
@@ -284,6 +340,9 @@ bool protocol_main_loop(bool cold_start)
         if(!protocol_execute_realtime() && sys.abort) // Runtime command check point.
             return !sys.flags.exit;                   // Bail to main() program loop to reset system.
 
+        // Start or extend continuous jog motion, only done here between lines.
+        mc_jog_continuous_update();
+
         sys.cancel = false;
 
         // Check for sleep conditions and execute auto-park, if timeout duration elapses.
@@ -403,8 +462,7 @@ bool protocol_exec_rt_system ()
                     report_realtime_status();
                 }
 
-                if(hal.execute_realtime)
-                    hal.execute_realtime(STATE_ESTOP);
+                task_run(STATE_ESTOP);
             }
             system_clear_exec_alarm(); // Clear alarm
         }
@@ -416,6 +474,7 @@ bool protocol_exec_rt_system ()
         if (rt_exec & EXEC_RESET) {
 
             hal.driver_reset();
+            hooks_dispatch(reset);
 
             sys.abort = !hal.system_control_get_state().e_stop;  // Only place this is set true.
             return !sys.abort; // Nothing else to do but exit.
@@ -442,6 +501,7 @@ bool protocol_exec_rt_system ()
             sys.report.spindle = sys.report.coolant = On; // Set to report change immediately
 
             hal.driver_reset();
+            hooks_dispatch(reset);
 
             if(hal.stream.suspend_read && hal.stream.suspend_read(false))
                 hal.stream.cancel_read_buffer(); // flush pending blocks (after M6)
@@ -458,12 +518,8 @@ bool protocol_exec_rt_system ()
         if (rt_exec & EXEC_STATUS_REPORT)
             report_realtime_status();
 
-        if(rt_exec & EXEC_GCODE_REPORT)
-            report_gcode_modes();
-
-        // Execute and print PID log to output stream
-        if (rt_exec & EXEC_PID_REPORT)
-            report_pid_log();
+        // Defer multi line reports to the report task
+        pending_reports |= rt_exec & (EXEC_GCODE_REPORT|EXEC_PID_REPORT);
 
         rt_exec &= ~(EXEC_STOP|EXEC_STATUS_REPORT|EXEC_GCODE_REPORT|EXEC_PID_REPORT); // clear requests already processed
 
@@ -479,9 +535,6 @@ bool protocol_exec_rt_system ()
             update_state(rt_exec);
     }
 
-    if(hal.execute_realtime)
-        hal.execute_realtime(sys.state);
-
     if(!sys.flags.delay_overrides) {
 
         // Execute overrides.
@@ -606,9 +659,9 @@ bool protocol_exec_rt_system ()
         }
     } // End execute overrides.
 
-    // Reload step segment buffer
-    if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_SAFETY_DOOR | STATE_HOMING | STATE_SLEEP| STATE_JOG))
-        st_prep_buffer();
+    // Reload step segment buffer, then run due foreground tasks: driver and plugin polling, reports etc.
+    task_yield();
+    task_run(sys.state);
 
     return !ABORTED;
 }
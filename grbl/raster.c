@@ -0,0 +1,141 @@
+/*
+  raster.c - laser raster scanlines with per pixel power
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#ifdef LASER_RASTER_MODE
+
+#define RASTER_ARGS 3
+
+// Returns pixel value (0 - 63) of a base64 character, -1 if invalid.
+static int_fast8_t raster_pixel (char c)
+{
+    if(c >= 'A' && c <= 'Z')
+        return c - 'A';
+    if(c >= 'a' && c <= 'z')
+        return c - 'a' + 26;
+    if(c >= '0' && c <= '9')
+        return c - '0' + 52;
+
+    return c == '+' ? 62 : (c == '/' ? 63 : -1);
+}
+
+// Queues a scanline starting at the current position, the laser power is set per pixel by the stepper ISR.
+// Format: $L=<X direction>,<Y direction>,<pixel pitch>:<pixels>
+// Pixels are base64 characters, one per pixel, with power from 0 (A) to the programmed S value (/).
+// Pixel pitch is in the current units, feed rate and laser power are taken from the parser state.
+status_code_t raster_command (char *line)
+{
+    uint_fast8_t counter = 0, idx = 0;
+    uint_fast16_t length;
+    int_fast8_t pixel;
+    float args[RASTER_ARGS], target[N_AXIS], len, steps;
+    laser_raster_t *raster;
+    plan_line_data_t plan_data;
+
+    if(line[counter++] != '=')
+        return Status_InvalidStatement;
+
+    if(sys.state & (STATE_ALARM|STATE_ESTOP|STATE_JOG))
+        return Status_SystemGClock; // Same as for g-code.
+
+    do {
+        if(!read_float(line, &counter, &args[idx]))
+            return Status_BadNumberFormat;
+    } while(++idx < RASTER_ARGS && line[counter++] == ',');
+
+    if(idx != RASTER_ARGS || line[counter++] != ':')
+        return Status_InvalidStatement;
+
+    if((length = strlen(&line[counter])) == 0 || (len = sqrtf(args[0] * args[0] + args[1] * args[1])) == 0.0f)
+        return Status_InvalidStatement;
+
+    if(args[2] <= 0.0f || gc_state.feed_rate <= 0.0f)
+        return Status_NonPositiveValue;
+
+    if(!settings.flags.laser_mode || gc_state.modal.feed_mode != FeedMode_UnitsPerMin)
+        return Status_GcodeUnsupportedCommand;
+
+#ifdef HEIGHT_MAP_COMPENSATION
+    if(heightmap_is_active())
+        return Status_GcodeUnsupportedCommand; // Scanlines are not split for Z compensation.
+#endif
+
+#ifdef KINEMATICS_API
+    if(kinematics.segment_target_to_steps)
+        return Status_GcodeUnsupportedCommand;
+#endif
+
+    if(!gc_state.modal.spindle.on)
+        return Status_GcodeSpindleNotRunning;
+
+    if(gc_state.modal.units_imperial)
+        args[2] *= MM_PER_INCH;
+
+    // Each pixel must span at least one step on the axis tracking pixel boundaries.
+    args[0] *= args[2] / len;
+    args[1] *= args[2] / len;
+    steps = max(fabsf(args[0]) * settings.steps_per_mm[X_AXIS], fabsf(args[1]) * settings.steps_per_mm[Y_AXIS]);
+    if(steps < 1.0f)
+        return Status_GcodeValueOutOfRange;
+
+    memcpy(target, gc_state.position, sizeof(target));
+    target[X_AXIS] += args[0] * (float)length;
+    target[Y_AXIS] += args[1] * (float)length;
+
+    if(settings.limits.flags.soft_enabled && !system_check_travel_limits(target))
+        return Status_TravelExceeded;
+
+    if(!(raster = malloc(sizeof(laser_raster_t) + length * sizeof(raster->power[0]))))
+        return Status_Overflow; // No memory for the scanline.
+
+    raster->length = length;
+    line += counter;
+    for(idx = 0; idx < length; idx++) {
+        if((pixel = raster_pixel(line[idx])) < 0) {
+            free(raster);
+            return Status_InvalidStatement;
+        }
+        raster->power[idx] = pixel;
+    }
+
+    if(sys.state == STATE_CHECK_MODE) {
+        free(raster);
+        memcpy(gc_state.position, target, sizeof(target));
+        return Status_OK;
+    }
+
+    memset(&plan_data, 0, sizeof(plan_line_data_t));
+    memcpy(&plan_data.spindle, &gc_state.spindle, sizeof(spindle_t));
+    plan_data.feed_rate = gc_state.feed_rate;
+    plan_data.line_number = gc_state.line_number;
+    plan_data.condition.spindle = gc_state.modal.spindle;
+    plan_data.condition.coolant = gc_state.modal.coolant;
+    plan_data.raster = raster;
+
+    mc_line(target, &plan_data);
+
+    if(plan_data.raster)
+        free(plan_data.raster); // Not queued, zero length line or aborted.
+
+    memcpy(gc_state.position, target, sizeof(target));
+
+    return Status_OK;
+}
+
+#endif
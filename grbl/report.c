@@ -305,6 +305,8 @@ void report_grbl_help (void)
 
 void report_uint_setting (setting_type_t n, uint32_t val)
 {
+    task_yield(); // Settings are reported one line at a time, keep the segment buffer topped up in between.
+
     hal.stream.write(appendbuf(3, "$", uitoa((uint32_t)n), "="));
     hal.stream.write(appendbuf(2, uitoa(val), "\r\n"));
 }
@@ -312,6 +314,8 @@ void report_uint_setting (setting_type_t n, uint32_t val)
 
 void report_float_setting (setting_type_t n, float val, uint8_t n_decimal)
 {
+    task_yield();
+
     hal.stream.write(appendbuf(3, "$", uitoa((uint32_t)n), "="));
     hal.stream.write(appendbuf(2, ftoa(val, n_decimal), "\r\n"));
 }
@@ -494,6 +498,15 @@ void report_grbl_settings (void)
         val += AXIS_SETTINGS_INCREMENT;
     }
 
+#ifdef INPUT_SHAPING
+    val = (uint_fast8_t)Setting_AxisSettingsBase + AxisSetting_ShaperFrequency * AXIS_SETTINGS_INCREMENT;
+    for (idx = 0; idx < N_AXIS; idx++) {
+        report_float_setting((setting_type_t)(val + idx), settings.shaper[idx].frequency, N_DECIMAL_SETTINGVALUE);
+        report_float_setting((setting_type_t)(val + AXIS_SETTINGS_INCREMENT + idx), settings.shaper[idx].damping, N_DECIMAL_SETTINGVALUE);
+        report_uint_setting((setting_type_t)(val + AXIS_SETTINGS_INCREMENT * 2 + idx), settings.shaper[idx].type);
+    }
+#endif
+
     if(hal.driver_settings_report) {
         for(idx = Setting_AxisSettingsMax + 1; idx <= Setting_SettingsMax; idx++)
             hal.driver_settings_report((setting_type_t)idx);
@@ -855,6 +868,22 @@ void report_build_info (char *line)
     strcat(buf, "PID,");
 #endif
 
+#ifdef ENABLE_STEPPER_TELEMETRY
+    strcat(buf, "STT,");
+#endif
+
+#ifdef HEIGHT_MAP_COMPENSATION
+    strcat(buf, "HMAP,");
+#endif
+
+#ifdef LASER_RASTER_MODE
+    strcat(buf, "RASTER,");
+#endif
+
+#ifdef INPUT_SHAPING
+    strcat(buf, "SHAPER,");
+#endif
+
     append = &buf[strlen(buf) - 1];
     if(*append == ',')
         *append = '\0';
@@ -1131,8 +1160,25 @@ void report_realtime_status (void)
             hal.stream.write_all(appendbuf(2, "|T:", uitoa((uint32_t)gc_state.tool->tool)));
     }
 
+#ifdef ENABLE_STEPPER_TELEMETRY
+    static uint32_t underruns = 0, starved_underruns = 0, planner_empty = 0;
+    st_telemetry_t *telemetry = st_get_telemetry();
+
+    if(telemetry->underruns != underruns || telemetry->starved_underruns != starved_underruns || telemetry->planner_empty != planner_empty) {
+        underruns = telemetry->underruns;
+        starved_underruns = telemetry->starved_underruns;
+        planner_empty = telemetry->planner_empty;
+        hal.stream.write_all(appendbuf(2, "|St:", uitoa(underruns)));
+        hal.stream.write_all(appendbuf(2, ",", uitoa(starved_underruns)));
+        hal.stream.write_all(appendbuf(2, ",", uitoa(planner_empty)));
+        hal.stream.write_all(appendbuf(2, ",", uitoa((uint32_t)telemetry->min_segments)));
+        hal.stream.write_all(appendbuf(2, ",", uitoa(telemetry->min_buffered_ms)));
+    }
+#endif
+
     if(hal.driver_rt_report)
         hal.driver_rt_report(hal.stream.write_all, sys.report);
+    hooks_dispatch(realtime_report, hal.stream.write_all, sys.report);
 
     sys.report.value = 0;
     sys.report.wco = settings.status_report.work_coord_offset && wco_counter == 0; // Set to report on next request
@@ -1156,6 +1202,30 @@ void report_realtime_status (void)
 }
 
 
+// Prints segment buffer underrun and planner starvation statistics.
+void report_stepper_telemetry (void)
+{
+#ifdef ENABLE_STEPPER_TELEMETRY
+    st_telemetry_t *telemetry = st_get_telemetry();
+
+    hal.stream.write("[ST:");
+    hal.stream.write(uitoa(telemetry->underruns));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(telemetry->starved_underruns));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(telemetry->planner_empty));
+    hal.stream.write(",");
+    hal.stream.write(uitoa((uint32_t)telemetry->min_segments));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(telemetry->min_buffered_ms));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(telemetry->last_underrun));
+    hal.stream.write(",");
+    hal.stream.write(uitoa(telemetry->last_planner_empty));
+    hal.stream.write("]" ASCII_EOL);
+#endif
+}
+
 void report_pid_log (void)
 {
 #ifdef PID_LOG
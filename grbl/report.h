@@ -70,6 +70,9 @@ void report_execute_startup_message (char *line, status_code_t status_code);
 // Prints build info and user info.
 void report_build_info (char *line);
 
+// Prints segment buffer underrun and planner starvation statistics.
+void report_stepper_telemetry (void);
+
 // Prints current PID log.
 void report_pid_log (void);
 
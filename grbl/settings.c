@@ -26,7 +26,9 @@
 #include <stdio.h>
 #endif
 
+#ifndef SETTINGS_FROZEN
 settings_t settings;
+#endif
 
 const settings_restore_t settings_all = {
     .defaults          = SETTINGS_RESTORE_DEFAULTS,
@@ -36,7 +38,11 @@ const settings_restore_t settings_all = {
     .driver_parameters = SETTINGS_RESTORE_DRIVER_PARAMETERS
 };
 
+#ifdef SETTINGS_FROZEN
+const settings_t settings = { // The global settings are the compile time defaults, stored in flash.
+#else
 const settings_t defaults = {
+#endif
 
     .version = SETTINGS_VERSION,
 
@@ -279,23 +285,30 @@ bool settings_read_tool_data (uint8_t tool, tool_data_t *tool_data)
 // Read Grbl global settings from persistent storage.
 bool read_global_settings ()
 {
+#ifdef SETTINGS_FROZEN
+    return true;
+#else
     // Check version-byte of eeprom
     return hal.eeprom.type != EEPROM_None && SETTINGS_VERSION == hal.eeprom.get_byte(0) && hal.eeprom.memcpy_from_with_checksum((uint8_t *)&settings, EEPROM_ADDR_GLOBAL, sizeof(settings_t));
+#endif
 }
 
 // Write Grbl global settings and version number to persistent storage
 void write_global_settings ()
 {
+#ifndef SETTINGS_FROZEN
     if(hal.eeprom.type != EEPROM_None) {
         hal.eeprom.put_byte(0, SETTINGS_VERSION);
         hal.eeprom.memcpy_to_with_checksum(EEPROM_ADDR_GLOBAL, (uint8_t *)&settings, sizeof(settings_t));
     }
+#endif
 }
 
 
 // Restore Grbl global settings to defaults and write to persistent storage
 void settings_restore (settings_restore_t restore) {
 
+#ifndef SETTINGS_FROZEN
     if (restore.defaults) {
         memcpy(&settings, &defaults, sizeof(settings_t));
 
@@ -308,6 +321,7 @@ void settings_restore (settings_restore_t restore) {
 
         write_global_settings();
     }
+#endif
 
     if (restore.parameters) {
         uint_fast8_t idx;
@@ -353,6 +367,18 @@ status_code_t settings_store_global_setting (setting_type_t setting, char *svalu
     uint_fast8_t set_idx = 0;
     float value;
 
+#ifdef SETTINGS_FROZEN
+
+    // Global settings are compile time constants, only driver settings can be changed.
+    status_code_t status = Status_Unhandled;
+
+    if(hal.driver_setting)
+        status = hal.driver_setting(setting, read_float(svalue, &set_idx, &value) ? value : NAN, svalue);
+
+    return status == Status_Unhandled ? Status_SettingDisabled : status;
+
+#else
+
     if (!read_float(svalue, &set_idx, &value)) {
         status_code_t status;
         if(hal.driver_setting && (status = hal.driver_setting(setting, NAN, svalue)) != Status_Unhandled)
@@ -412,6 +438,33 @@ status_code_t settings_store_global_setting (setting_type_t setting, char *svalu
                 break;
 #endif
 
+#ifdef INPUT_SHAPING
+            case AxisSetting_ShaperFrequency:
+                if(value < 0.0f)
+                    return Status_NegativeValue; // Checked regardless of compatibility level, 0 disables the shaper.
+                if(value > 0.0f && value < 1.0f)
+                    return Status_InvalidStatement;
+                found = true;
+                settings.shaper[axis_idx].frequency = value;
+                break;
+
+            case AxisSetting_ShaperDamping:
+                if(value < 0.0f)
+                    return Status_NegativeValue; // A negative damping ratio results in an amplifying or invalid (NaN) shaper.
+                if(value >= 1.0f)
+                    return Status_InvalidStatement;
+                found = true;
+                settings.shaper[axis_idx].damping = value;
+                break;
+
+            case AxisSetting_ShaperType:
+                if(!isintf(value) || value < 0.0f || value > (float)Shaper_EI)
+                    return Status_InvalidStatement;
+                found = true;
+                settings.shaper[axis_idx].type = (shaper_type_t)value;
+                break;
+#endif
+
             default: // for stopping compiler warning
                 break;
         }
@@ -802,12 +855,18 @@ status_code_t settings_store_global_setting (setting_type_t setting, char *svalu
     }
 
     write_global_settings();
+    plan_axis_limits_init();
 #ifdef ENABLE_BACKLASH_COMPENSATION
-    mc_backlash_init();
+    st_backlash_init();
+#endif
+#ifdef INPUT_SHAPING
+    st_shaper_init();
 #endif
     hal.settings_changed(&settings);
 
     return Status_OK;
+
+#endif
 }
 
 // Initialize the config subsystem
@@ -828,9 +887,16 @@ void settings_init() {
 #endif
         report_init();
 #ifdef ENABLE_BACKLASH_COMPENSATION
-        mc_backlash_init();
+        st_backlash_init();
+#endif
+#ifdef INPUT_SHAPING
+        st_shaper_init();
 #endif
+  #ifdef SETTINGS_FROZEN
+        hal.settings_changed((settings_t *)&settings);
+  #else
         hal.settings_changed(&settings);
+  #endif
         if(hal.probe_configure_invert_mask) // Initialize probe invert mask.
             hal.probe_configure_invert_mask(false);
     }
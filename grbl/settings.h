@@ -248,15 +248,30 @@ typedef enum {
     AxisSetting_MaxTravel = 3,
     AxisSetting_StepperCurrent = 4,
     AxisSetting_MicroSteps = 5,
-    AxisSetting_Backlash = 6
+    AxisSetting_Backlash = 6,
     /*
     AxisSetting_P_Gain = 7,
     AxisSetting_I_Gain = 8,
     AxisSetting_D_Gain = 9,
-    AxisSetting_I_MaxError = 10
+    AxisSetting_I_MaxError = 10,
     */
+    AxisSetting_ShaperFrequency = 11,
+    AxisSetting_ShaperDamping = 12,
+    AxisSetting_ShaperType = 13
 } axis_setting_type_t;
 
+typedef enum {
+    Shaper_ZV = 0,
+    Shaper_ZVD = 1,
+    Shaper_EI = 2
+} shaper_type_t;
+
+typedef struct {
+    float frequency;    // Vibration frequency (Hz), 0 if disabled
+    float damping;      // Damping ratio (0 - 0.99)
+    shaper_type_t type;
+} input_shaper_settings_t;
+
 typedef union {
     uint8_t mask;
     struct {
@@ -420,6 +435,9 @@ typedef struct {
     float max_travel[N_AXIS];
 #ifdef ENABLE_BACKLASH_COMPENSATION
     float backlash[N_AXIS];
+#endif
+#ifdef INPUT_SHAPING
+    input_shaper_settings_t shaper[N_AXIS];
 #endif
     float junction_deviation;
     float arc_tolerance;
@@ -512,7 +530,11 @@ typedef struct {
 
 // End of setting structs that may be used by drivers
 
+#ifdef SETTINGS_FROZEN
+extern const settings_t settings; // Compile time constant, see SETTINGS_FROZEN in config.h.
+#else
 extern settings_t settings;
+#endif
 
 // Initialize the configuration subsystem (load settings from persistent storage)
 void settings_init();
@@ -22,6 +22,13 @@
 
 #include "grbl.h"
 
+#ifdef SPINDLE_SPINUP_OVERLAP
+static struct {
+    bool pending;
+    uint32_t started; // Timestamp (ms) of spindle start
+} spinup = {0};
+#endif
+
 // Set spindle speed override
 // NOTE: Unlike motion overrides, spindle overrides do not require a planner reinitialization.
 void spindle_set_override (uint_fast8_t speed_override)
@@ -35,8 +42,11 @@ void spindle_set_override (uint_fast8_t speed_override)
         sys.override.spindle_rpm = (uint8_t)speed_override;
         if(sys.state == STATE_IDLE)
             spindle_set_state(gc_state.modal.spindle, gc_state.spindle.rpm);
-        else
+        else {
+            st_prep_lock(); // sys.step_control is also written by the segment generator, it may run in interrupt context.
             sys.step_control.update_spindle_rpm = On;
+            st_prep_unlock();
+        }
        sys.report.overrides = On; // Set to report change immediately
     }
 }
@@ -76,13 +86,27 @@ bool spindle_sync (spindle_state_t state, float rpm)
 
     if (sys.state != STATE_CHECK_MODE) {
         // Empty planner buffer to ensure spindle is set when programmed.
-        if((ok = protocol_buffer_synchronize()) && spindle_set_state(state, rpm) && !at_speed) {
-            float delay = 0.0f;
-            while(!(at_speed = hal.spindle_get_state().at_speed)) {
-                delay_sec(0.1f, DelayMode_Dwell);
-                delay += 0.1f;
-                if(ABORTED || delay >= SAFETY_DOOR_SPINDLE_DELAY)
-                    break;
+        if((ok = protocol_buffer_synchronize()) && spindle_set_state(state, rpm)) {
+          #ifdef SPINDLE_SPINUP_OVERLAP
+            if(state.on && !settings.flags.laser_mode && (!at_speed || SPINDLE_SPINUP_TIME > 0.0f)) {
+                // Defer waiting for the spindle to get up to speed to the first feed motion.
+                // Spin-up is timed from here so a time base is required, without one wait now.
+                if((spinup.pending = hal.get_elapsed_ticks != NULL)) {
+                    spinup.started = hal.get_elapsed_ticks();
+                    return true;
+                }
+                if(at_speed)
+                    delay_sec(SPINDLE_SPINUP_TIME, DelayMode_Dwell);
+            }
+          #endif
+            if(!at_speed) {
+                float delay = 0.0f;
+                while(!(at_speed = hal.spindle_get_state().at_speed)) {
+                    delay_sec(0.1f, DelayMode_Dwell);
+                    delay += 0.1f;
+                    if(ABORTED || delay >= SAFETY_DOOR_SPINDLE_DELAY)
+                        break;
+                }
             }
         }
     }
@@ -90,14 +114,60 @@ bool spindle_sync (spindle_state_t state, float rpm)
     return ok && at_speed;
 }
 
+#ifdef SPINDLE_SPINUP_OVERLAP
+
+bool spindle_spinup_pending (void)
+{
+    return spinup.pending;
+}
+
+// Called by mc_line() before a feed motion is planned. Queued rapid motions are started and executed
+// while waiting, spin-up time is measured from spindle start.
+// Raises an alarm if the spindle does not report at speed within SAFETY_DOOR_SPINDLE_DELAY seconds.
+// Returns false on abort or alarm.
+bool spindle_spinup_wait (void)
+{
+    uint32_t elapsed;
+
+    spinup.pending = false;
+
+    protocol_auto_cycle_start(); // Start queued motions, if not already running.
+
+    while(!ABORTED && hal.spindle_get_state().on) {
+
+        elapsed = hal.get_elapsed_ticks() - spinup.started;
+
+        if(hal.driver_cap.spindle_at_speed) {
+            if(hal.spindle_get_state().at_speed)
+                break;
+            if(elapsed >= (uint32_t)(SAFETY_DOOR_SPINDLE_DELAY * 1000.0f)) {
+                mc_reset(); // Stop queued motions and shut down spindle and coolant.
+                system_set_exec_alarm(Alarm_Spindle);
+                protocol_execute_realtime(); // Execute to enter critical event loop and system abort
+                return false;
+            }
+        } else if(elapsed >= (uint32_t)(SPINDLE_SPINUP_TIME * 1000.0f))
+            break;
+
+        protocol_execute_realtime();
+        hal.delay_ms(10, NULL);
+    }
+
+    return !ABORTED;
+}
+
+#endif
+
 // Restore spindle running state with direction, enable, spindle RPM and appropriate delay.
 bool spindle_restore (spindle_state_t state, float rpm)
 {
     bool ok = true;
 
-    if(settings.flags.laser_mode) // When in laser mode, ignore spindle spin-up delay. Set to turn on laser when cycle starts.
+    if(settings.flags.laser_mode) { // When in laser mode, ignore spindle spin-up delay. Set to turn on laser when cycle starts.
+        st_prep_lock();
         sys.step_control.update_spindle_rpm = On;
-    else { // TODO: add check for current spindle state matches restore state?
+        st_prep_unlock();
+    } else { // TODO: add check for current spindle state matches restore state?
         spindle_set_state(state, rpm);
         if((ok = !hal.driver_cap.spindle_at_speed))
             delay_sec(SAFETY_DOOR_SPINDLE_DELAY, DelayMode_SysSuspend);
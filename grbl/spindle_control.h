@@ -93,6 +93,14 @@ float spindle_set_rpm (float rpm, uint8_t speed_override);
 // Restore spindle running state with direction, enable, spindle RPM and appropriate delay.
 bool spindle_restore (spindle_state_t state, float rpm);
 
+#ifdef SPINDLE_SPINUP_OVERLAP
+// Returns true if spindle spin-up is pending completion.
+bool spindle_spinup_pending (void);
+
+// Waits for spindle spin-up to complete while already queued motions are executed.
+bool spindle_spinup_wait (void);
+#endif
+
 //
 // The following functions are not called by the core, may be called by driver code.
 //
@@ -98,7 +98,9 @@ bool initiate_hold (uint_fast16_t new_state)
 
     if(sys.state & (STATE_CYCLE|STATE_JOG)) {
         st_update_plan_block_parameters();  // Notify stepper module to recompute for hold deceleration.
+        st_prep_lock(); // sys.step_control is also written by the segment generator, it may run in interrupt context.
         sys.step_control.execute_hold = On; // Initiate suspend state with active flag.
+        st_prep_unlock();
         stateHandler = state_await_hold;
     }
 
@@ -239,9 +241,11 @@ void state_suspend_manager (void)
         // Handles restoring of spindle state
         if (sys.override.spindle_stop.restore) {
             hal.report.feedback_message(Message_SpindleRestore);
-            if (settings.flags.laser_mode) // When in laser mode, ignore spindle spin-up delay. Set to turn on laser when cycle starts.
+            if (settings.flags.laser_mode) { // When in laser mode, ignore spindle spin-up delay. Set to turn on laser when cycle starts.
+                st_prep_lock();
                 sys.step_control.update_spindle_rpm = On;
-            else
+                st_prep_unlock();
+            } else
                 spindle_set_state(restore_condition.spindle, restore_spindle_rpm);
             sys.override.spindle_stop.value = 0; // Clear stop override state
         }
@@ -249,7 +253,9 @@ void state_suspend_manager (void)
     } else if (sys.step_control.update_spindle_rpm && hal.spindle_get_state().on) {
         // Handles spindle state during hold. NOTE: Spindle speed overrides may be altered during hold state.
         spindle_set_state(restore_condition.spindle, restore_spindle_rpm);
+        st_prep_lock();
         sys.step_control.update_spindle_rpm = Off;
+        st_prep_unlock();
     }
 }
 
@@ -281,7 +287,9 @@ static void state_cycle (uint_fast16_t rt_exec)
     if (rt_exec & EXEC_MOTION_CANCEL) {
         st_update_plan_block_parameters();  // Notify stepper module to recompute for hold deceleration.
         sys.suspend = true;
+        st_prep_lock();
         sys.step_control.execute_hold = On; // Initiate suspend state with active flag.
+        st_prep_unlock();
         stateHandler = state_await_motion_cancel;
     }
 
@@ -313,9 +321,6 @@ static void state_await_motion_cancel (uint_fast16_t rt_exec)
             st_reset();
             gc_sync_position();
             plan_sync_position();
-#ifdef ENABLE_BACKLASH_COMPENSATION
-            mc_sync_backlash_position();
-#endif
             sys.suspend = false;
         }
         set_state(pending_state);
@@ -404,7 +409,9 @@ static void state_await_resume (uint_fast16_t rt_exec)
 {
     if((rt_exec & EXEC_CYCLE_COMPLETE) && settings.parking.flags.enabled) {
         if(sys.step_control.execute_sys_motion) {
+            st_prep_lock();
             sys.step_control.execute_sys_motion = Off;
+            st_prep_unlock();
             st_parking_restore_buffer(); // Restore step segment buffer to normal run state.
         }
         sys.parking_state = Parking_DoorAjar;
@@ -526,8 +533,10 @@ static void restart_retract (void)
 
     if (sys.step_control.execute_sys_motion) {
         st_update_plan_block_parameters(); // Notify stepper module to recompute for hold deceleration.
+        st_prep_lock();
         sys.step_control.execute_hold = On;
         sys.step_control.execute_sys_motion = On;
+        st_prep_unlock();
     } else // else NO_MOTION is active.
         stateHandler(EXEC_CYCLE_COMPLETE);
 }
@@ -539,7 +548,9 @@ static void state_await_waypoint_cancel (uint_fast16_t rt_exec)
 
     else if (rt_exec & EXEC_CYCLE_COMPLETE) {
         sys.parking_state = Parking_Cancel;
+        st_prep_lock();
         sys.step_control.execute_hold = Off;
+        st_prep_unlock();
         state_restore(rt_exec);
     }
 }
@@ -549,7 +560,9 @@ static void state_await_waypoint_retract (uint_fast16_t rt_exec)
     if (rt_exec & EXEC_CYCLE_COMPLETE) {
 
         if(sys.step_control.execute_sys_motion) {
+            st_prep_lock();
             sys.step_control.execute_sys_motion = Off;
+            st_prep_unlock();
             st_parking_restore_buffer(); // Restore step segment buffer to normal run state.
         }
 
@@ -580,8 +593,10 @@ static void state_await_waypoint_retract (uint_fast16_t rt_exec)
 
         if (sys.step_control.execute_sys_motion) {
             st_update_plan_block_parameters(); // Notify stepper module to recompute for hold deceleration.
+            st_prep_lock();
             sys.step_control.execute_hold = On;
             sys.step_control.execute_sys_motion = On;
+            st_prep_unlock();
         } else // else NO_MOTION is active.
             stateHandler(EXEC_CYCLE_COMPLETE);
     }
@@ -595,7 +610,9 @@ static void state_restore (uint_fast16_t rt_exec)
     else if (rt_exec & EXEC_CYCLE_COMPLETE) {
 
         if(sys.step_control.execute_sys_motion) {
+            st_prep_lock();
             sys.step_control.execute_sys_motion = Off;
+            st_prep_unlock();
             st_parking_restore_buffer(); // Restore step segment buffer to normal run state.
         }
 
@@ -26,8 +26,27 @@
 
 // Some useful constants.
 #define DT_SEGMENT (1.0f/(ACCELERATION_TICKS_PER_SECOND*60.0f)) // min/segment
+#ifdef SEGMENT_CRUISE_TICKS_PER_SECOND
+#define DT_SEGMENT_CRUISE (1.0f/(SEGMENT_CRUISE_TICKS_PER_SECOND*60.0f)) // min/segment
+#endif
 #define REQ_MM_INCREMENT_SCALAR 1.25f
 
+#ifdef __GNUC__
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define ALWAYS_INLINE inline
+#endif
+
+// Step pulse output and step timer reload, bound at compile time if the driver provides inline versions.
+#ifdef HAL_STEPPER_INLINE
+#include HAL_STEPPER_INLINE
+#define stepper_pulse_start(stepper) driver_stepper_pulse_start(stepper)
+#define stepper_cycles_per_tick(cycles_per_tick) driver_stepper_cycles_per_tick(cycles_per_tick)
+#else
+#define stepper_pulse_start(stepper) hal.stepper_pulse_start(stepper)
+#define stepper_cycles_per_tick(cycles_per_tick) hal.stepper_cycles_per_tick(cycles_per_tick)
+#endif
+
 typedef enum {
     Ramp_Accel,
     Ramp_Cruise,
@@ -63,6 +82,74 @@ static segment_t segment_buffer[SEGMENT_BUFFER_SIZE];
 // Stepper ISR data struct. Contains the running data for the main stepper ISR.
 static stepper_t st;
 
+#ifdef ENABLE_BACKLASH_COMPENSATION
+// Backlash take-up state. Direction reversals are detected when the ISR starts a new block, the
+// backlash is then taken up by extra steps that are not added to the machine position.
+static struct {
+    axes_signals_t enabled;             // Axes with backlash compensation
+    axes_signals_t dir;                 // Direction of last motion per axis, set for negative
+    axes_signals_t pending;             // Axes with backlash steps to be output
+    uint32_t steps[N_AXIS];             // Backlash per axis in steps
+    uint32_t steps_pending[N_AXIS];     // Remaining backlash steps to be output
+} backlash = {0};
+#endif
+
+#ifdef LASER_POWER_RATE_SYNC
+// Laser power ramp state for rate adjusted (M4) motions. The PWM value is ramped from the power at the start
+// of the segment to the power at the end of it, following the segment acceleration or deceleration.
+static struct {
+    int32_t pwm;                        // Current PWM value in 24.8 fixed point format
+    int32_t delta;                      // PWM change per update, 0 if not ramping
+    uint_fast8_t ticks;                 // ISR ticks remaining until next update
+} laser_ramp = {0};
+#endif
+
+#ifdef LASER_RASTER_MODE
+// Raster scanline execution state. Pixel boundaries are tracked by counting the steps output on
+// the axis with most steps, the laser power is updated by the ISR when a boundary is crossed.
+static struct {
+    laser_raster_t *line;               // Executing scanline, NULL if none
+    axes_signals_t axis;                // Axis tracking pixel boundaries
+    uint_fast16_t pixel;                // Current pixel
+    uint32_t boundary;                  // Axis steps at end of current pixel in 24.8 fixed point format
+    uint32_t steps;                     // Remaining axis steps in current pixel
+} raster = {0};
+#endif
+
+#ifdef INPUT_SHAPING
+
+#define INPUT_SHAPER_HISTORY (SEGMENT_BUFFER_SIZE * 3)
+
+typedef struct {
+    float t;    // Unshaped time at end of segment (s), relative to the oldest point
+    float s;    // Path distance at end of segment (mm), relative to the oldest point
+} shaper_point_t;
+
+// Input shaper state. The path distance over time of the prepped segments, the unshaped time line, is
+// convolved with the shaper impulses and segments are retimed to when the shaped motion reaches their end.
+// Segments are held back from the ISR until the time line extends far enough to determine this.
+static struct {
+    uint_fast8_t n_impulses;                        // Number of shaper impulses, 0 if shaping is disabled
+    float a[INPUT_SHAPER_MAX_IMPULSES];             // Impulse amplitudes, normalized to a sum of one
+    float t[INPUT_SHAPER_MAX_IMPULSES];             // Impulse delays (s)
+    float t_max;                                    // Longest impulse delay (s)
+    shaper_point_t point[INPUT_SHAPER_HISTORY];     // Unshaped time line, oldest first
+    uint_fast8_t n_points;                          // Number of points in the time line
+    uint_fast8_t n_pending;                         // Number of newest points for segments not released to the ISR
+    float t_shaped;                                 // Shaped time at end of the last released segment (s)
+    volatile uint_fast8_t head;                     // Segment buffer head as seen by the stepper ISR
+} shaper = {0};
+
+// Clears the unshaped time line, called when motion has stopped.
+static void shaper_reset (void)
+{
+    shaper.point[0].t = shaper.point[0].s = shaper.t_shaped = 0.0f;
+    shaper.n_points = 1;
+    shaper.n_pending = 0;
+}
+
+#endif
+
 #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
 typedef struct {
     uint32_t level_1;
@@ -112,10 +199,24 @@ typedef struct {
     float target_feed;      //
     float inv_feedrate;     // Used by PWM laser mode to speed up segment calculations.
     float current_spindle_rpm;
+#ifdef LASER_POWER_RATE_SYNC
+    uint_fast16_t current_pwm; // PWM value at the end of the last prepped segment.
+#endif
+#ifdef KINEMATICS_API
+    int32_t kin_steps[N_AXIS]; // Motor position at the end of the last prepped cartesian_motion segment (steps)
+    float kin_inv_mm;          // Inverse of cartesian_motion block length
+    bool kin_first;            // True until the first segment of a cartesian_motion block is prepped
+#endif
 } st_prep_t;
 
 static st_prep_t prep;
 
+#ifdef ENABLE_STEPPER_TELEMETRY
+static volatile bool planner_starved = false;
+static bool buffered_time_sampled = false;
+static st_telemetry_t telemetry = { .min_segments = SEGMENT_BUFFER_SIZE - 1 };
+#endif
+
 
 /*    BLOCK VELOCITY PROFILE DEFINITION
           __________________________
@@ -185,6 +286,10 @@ ISR_CODE void st_go_idle ()
 
     hal.stepper_go_idle(false);
 
+  #ifdef SPECIALIZED_STEPPER_ISR
+    hal.stepper_interrupt_callback = stepper_driver_interrupt_handler;
+  #endif
+
     // Set stepper driver idle state, disabled or enabled, depending on settings and circumstances.
     if (((settings.steppers.idle_lock_time != 0xff) || sys_rt_exec_alarm || sys.state == STATE_SLEEP) && sys.state != STATE_HOMING) {
         // Force stepper dwell to lock axes for a defined amount of time to ensure the axes come to a complete
@@ -196,6 +301,358 @@ ISR_CODE void st_go_idle ()
 }
 
 
+#ifdef ENABLE_BACKLASH_COMPENSATION
+
+// Checks for direction reversals of the axes moved by the new block, and sets up backlash take-up for them.
+inline static void backlash_block_start (void)
+{
+    uint_fast8_t idx = N_AXIS;
+    axes_signals_t reversed;
+
+    if((reversed.mask = (st.dir_outbits.mask ^ backlash.dir.mask) & backlash.enabled.mask)) do {
+        idx--;
+        if((reversed.mask & bit(idx)) && st.exec_block->steps[idx]) {
+            backlash.dir.mask ^= bit(idx);
+            // Steps not yet output for a previous reversal is slack still taken up in the new direction.
+            if((backlash.steps_pending[idx] = backlash.steps[idx] - backlash.steps_pending[idx]))
+                backlash.pending.mask |= bit(idx);
+            else
+                backlash.pending.mask &= ~bit(idx);
+        }
+    } while(idx);
+
+    // Take up remaining backlash in the direction of the reversal, also for axes not moved by the block.
+    st.dir_outbits.mask = (st.dir_outbits.mask & ~backlash.pending.mask) | (backlash.dir.mask & backlash.pending.mask);
+}
+
+// Returns true if an axis with backlash to take up is stepped by the line tracer on every tick.
+inline static bool backlash_hold (void)
+{
+    uint_fast8_t idx = N_AXIS;
+
+    do {
+        idx--;
+        if((backlash.pending.mask & bit(idx)) && st.steps[idx] == st.step_event_count)
+            return true;
+    } while(idx);
+
+    return false;
+}
+
+// Counts down remaining backlash steps for the given axes, returns the axes to step.
+inline static axes_signals_t backlash_step (axes_signals_t axes)
+{
+    uint_fast8_t idx = N_AXIS;
+
+    if(axes.mask) do {
+        idx--;
+        if((axes.mask & bit(idx)) && --backlash.steps_pending[idx] == 0)
+            backlash.pending.mask &= ~bit(idx);
+    } while(idx);
+
+    return axes;
+}
+
+void st_backlash_init (void)
+{
+    uint_fast8_t idx = N_AXIS;
+
+    backlash.enabled.mask = backlash.pending.mask = 0;
+
+    do {
+        idx--;
+        backlash.steps_pending[idx] = 0;
+        if((backlash.steps[idx] = (uint32_t)lroundf(settings.backlash[idx] * settings.steps_per_mm[idx])))
+            backlash.enabled.mask |= bit(idx);
+    } while(idx);
+
+    // Last motion is assumed to be the pull-off after homing, away from the homing direction.
+    backlash.dir.mask = ~settings.homing.dir_mask.mask & AXES_BITMASK;
+}
+
+#endif
+
+#ifdef LASER_RASTER_MODE
+
+// Sets laser power for the current scanline pixel.
+inline static void raster_set_power (void)
+{
+  #ifdef SPINDLE_PWM_DIRECT
+    hal.spindle_update_pwm(raster.line->power[raster.pixel]);
+  #else
+    hal.spindle_update_rpm(raster.line->power[raster.pixel]);
+  #endif
+}
+
+// Starts execution of a scanline at the first pixel.
+inline static void raster_start (void)
+{
+    raster.pixel = 0;
+    raster.axis.mask = bit(raster.line->axis);
+    raster.boundary = raster.line->pixel_steps;
+    raster.steps = raster.boundary >> 8;
+    raster_set_power();
+}
+
+// Advances to the next scanline pixel, the last pixel is kept until the end of the block.
+inline static void raster_next_pixel (void)
+{
+    if(raster.pixel < raster.line->length - 1) {
+        uint32_t boundary = raster.boundary;
+        raster.pixel++;
+        raster.boundary += raster.line->pixel_steps;
+        raster.steps = (raster.boundary >> 8) - (boundary >> 8);
+        raster_set_power();
+    }
+}
+
+#ifdef SEGMENT_PREP_IRQ
+static laser_raster_t *raster_released = NULL; // Scanlines released by the segment generator, freed by the foreground.
+#endif
+
+// Releases scanline data of a stepper block that is to be reused, the ISR is done with it.
+inline static void raster_release (st_block_t *block)
+{
+    if(block->raster) {
+      #ifdef SEGMENT_PREP_IRQ // May be called from interrupt context, free() is deferred to st_prep_buffer().
+        block->raster->next = raster_released;
+        raster_released = block->raster;
+      #else
+        free(block->raster);
+      #endif
+        block->raster = NULL;
+    }
+}
+
+// Sets up pixel boundary tracking from the planner block steps and converts pixel values to laser power.
+// NOTE: The spindle override in effect when the scanline is prepped applies to the whole scanline.
+static void raster_prep (laser_raster_t *line)
+{
+    uint_fast16_t idx;
+    float rpm = pl_block->condition.spindle.on ? pl_block->spindle.rpm : 0.0f;
+
+    line->axis = pl_block->steps[Y_AXIS] > pl_block->steps[X_AXIS] ? Y_AXIS : X_AXIS;
+    line->pixel_steps = (pl_block->steps[line->axis] << 8) / line->length;
+
+    for(idx = 0; idx < line->length; idx++) {
+      #ifdef SPINDLE_PWM_DIRECT
+        line->power[idx] = hal.spindle_get_pwm(spindle_set_rpm(rpm * (float)line->power[idx] / 63.0f, sys.override.spindle_rpm));
+      #else
+        line->power[idx] = spindle_set_rpm(rpm * line->power[idx] / 63.0f, sys.override.spindle_rpm);
+      #endif
+    }
+
+    spindle_set_rpm(rpm, sys.override.spindle_rpm);
+}
+
+#endif
+
+#ifdef SEGMENT_PREP_IRQ
+
+// Frees memory released by the segment generator, it may run in interrupt context.
+// Must be called from the foreground with the segment prep interrupt locked out.
+static void prep_free_released (void)
+{
+  #ifdef LASER_RASTER_MODE
+    laser_raster_t *line;
+
+    while((line = raster_released)) {
+        raster_released = line->next;
+        free(line);
+    }
+  #endif
+
+    plan_free_discarded();
+}
+
+#endif
+
+// Discards the completed segment. With SEGMENT_PREP_IRQ requests segment prep when the buffer runs low.
+static ALWAYS_INLINE void segment_complete (void)
+{
+    st.exec_segment = NULL;
+    segment_buffer_tail = segment_buffer_tail == (SEGMENT_BUFFER_SIZE - 1) ? 0 : segment_buffer_tail + 1;
+
+#ifdef SEGMENT_PREP_IRQ
+    if(hal.stepper_prep_request) {
+        uint_fast8_t tail = segment_buffer_tail;
+        if((segment_buffer_head >= tail ? segment_buffer_head - tail : SEGMENT_BUFFER_SIZE - tail + segment_buffer_head) <= SEGMENT_PREP_THRESHOLD)
+            hal.stepper_prep_request();
+    }
+#endif
+}
+
+// Executes one tick of the Bresenham line tracer for the first n_axis axes, returns the axes to step.
+// n_axis is a compile time constant, the tracer is inlined and specialized for it by the compiler.
+static ALWAYS_INLINE axes_signals_t line_trace (const uint_fast8_t n_axis)
+{
+    register axes_signals_t step_outbits = (axes_signals_t){0};
+
+    st.counter_x += st.steps[X_AXIS];
+    if (st.counter_x > st.step_event_count) {
+        step_outbits.x = On;
+        st.counter_x -= st.step_event_count;
+        sys_position[X_AXIS] = sys_position[X_AXIS] + (st.dir_outbits.x ? -1 : 1);
+    }
+
+    if(n_axis > Y_AXIS) {
+        st.counter_y += st.steps[Y_AXIS];
+        if (st.counter_y > st.step_event_count) {
+            step_outbits.y = On;
+            st.counter_y -= st.step_event_count;
+            sys_position[Y_AXIS] = sys_position[Y_AXIS] + (st.dir_outbits.y ? -1 : 1);
+        }
+    }
+
+    if(n_axis > Z_AXIS) {
+        st.counter_z += st.steps[Z_AXIS];
+        if (st.counter_z > st.step_event_count) {
+            step_outbits.z = On;
+            st.counter_z -= st.step_event_count;
+            sys_position[Z_AXIS] = sys_position[Z_AXIS] + (st.dir_outbits.z ? -1 : 1);
+        }
+    }
+
+  #ifdef A_AXIS
+    if(n_axis > A_AXIS) {
+        st.counter_a += st.steps[A_AXIS];
+        if (st.counter_a > st.step_event_count) {
+            step_outbits.a = On;
+            st.counter_a -= st.step_event_count;
+            sys_position[A_AXIS] = sys_position[A_AXIS] + (st.dir_outbits.a ? -1 : 1);
+        }
+    }
+  #endif
+
+  #ifdef B_AXIS
+    if(n_axis > B_AXIS) {
+        st.counter_b += st.steps[B_AXIS];
+        if (st.counter_b > st.step_event_count) {
+            step_outbits.b = On;
+            st.counter_b -= st.step_event_count;
+            sys_position[B_AXIS] = sys_position[B_AXIS] + (st.dir_outbits.b ? -1 : 1);
+        }
+    }
+  #endif
+
+  #ifdef C_AXIS
+    if(n_axis > C_AXIS) {
+        st.counter_c += st.steps[C_AXIS];
+        if (st.counter_c > st.step_event_count) {
+            step_outbits.c = On;
+            st.counter_c -= st.step_event_count;
+            sys_position[C_AXIS] = sys_position[C_AXIS] + (st.dir_outbits.c ? -1 : 1);
+        }
+    }
+  #endif
+
+    return step_outbits;
+}
+
+#ifdef SPECIALIZED_STEPPER_ISR
+
+/* Specialized stepper ISRs. These handle the ticks of segments that need no processing other than
+   tracing the axes moved by the block and, when probing, checking the probe input. They are
+   swapped in as hal.stepper_interrupt_callback by the generic ISR when it loads a segment, and swap
+   the generic ISR back when the segment is completed so that it loads the next one. Homing,
+   backlash take-up, laser raster and laser power ramping run the generic ISR.
+*/
+static ALWAYS_INLINE void stepper_isr_specialized (const uint_fast8_t n_axis, const bool probing)
+{
+    // Start a step pulse, a block is always executing when a specialized ISR is active.
+    stepper_pulse_start(&st);
+    hooks_dispatch(step_pulse, &st);
+
+    if (probing && sys_probe_state == Probe_Active && hal.probe_get_state()) {
+        sys_probe_state = Probe_Off;
+        memcpy(sys_probe_position, sys_position, sizeof(sys_position));
+        system_set_exec_state_flag(EXEC_MOTION_CANCEL);
+    }
+
+    st.step_outbits = line_trace(n_axis);
+
+    if (--st.step_count == 0) {
+        // Segment is complete. Discard current segment and advance segment indexing.
+        segment_complete();
+        hal.stepper_interrupt_callback = stepper_driver_interrupt_handler;
+    }
+}
+
+#define STEPPER_ISR(n) \
+static ISR_CODE void stepper_isr_##n (void) { stepper_isr_specialized(n, false); } \
+static ISR_CODE void stepper_isr_probe_##n (void) { stepper_isr_specialized(n, true); }
+
+STEPPER_ISR(1)
+STEPPER_ISR(2)
+STEPPER_ISR(3)
+#if N_AXIS > 3
+STEPPER_ISR(4)
+#endif
+#if N_AXIS > 4
+STEPPER_ISR(5)
+#endif
+#if N_AXIS > 5
+STEPPER_ISR(6)
+#endif
+
+// Specialized ISRs indexed by number of traced axes - 1, without and with probing.
+static void (* const stepper_isr[2][N_AXIS])(void) = {
+    {
+        stepper_isr_1, stepper_isr_2, stepper_isr_3,
+      #if N_AXIS > 3
+        stepper_isr_4,
+      #endif
+      #if N_AXIS > 4
+        stepper_isr_5,
+      #endif
+      #if N_AXIS > 5
+        stepper_isr_6,
+      #endif
+    },
+    {
+        stepper_isr_probe_1, stepper_isr_probe_2, stepper_isr_probe_3,
+      #if N_AXIS > 3
+        stepper_isr_probe_4,
+      #endif
+      #if N_AXIS > 4
+        stepper_isr_probe_5,
+      #endif
+      #if N_AXIS > 5
+        stepper_isr_probe_6,
+      #endif
+    }
+};
+
+// Selects the ISR for the remaining ticks of the segment just loaded by the generic ISR.
+static ALWAYS_INLINE void stepper_isr_select (void)
+{
+    if (st.step_count > 1 && sys.state != STATE_HOMING
+      #ifdef ENABLE_BACKLASH_COMPENSATION
+        && !backlash.pending.mask
+      #endif
+      #ifdef LASER_RASTER_MODE
+        && !raster.line
+      #endif
+      #ifdef LASER_POWER_RATE_SYNC
+        && !laser_ramp.delta
+      #endif
+       )
+        hal.stepper_interrupt_callback = stepper_isr[sys_probe_state == Probe_Active][st.exec_block->traced_axes - 1];
+}
+
+// Returns the number of axes the line tracer has to process for a block, the highest moving axis + 1.
+static uint_fast8_t traced_axes (uint32_t *steps)
+{
+    uint_fast8_t n_axis = N_AXIS;
+
+    while(n_axis > 1 && steps[n_axis - 1] == 0)
+        n_axis--;
+
+    return n_axis;
+}
+
+#endif
+
 /* "The Stepper Driver Interrupt" - This timer interrupt is the workhorse of Grbl. Grbl employs
    the venerable Bresenham line algorithm to manage and exactly synchronize multi-axis moves.
    Unlike the popular DDA algorithm, the Bresenham algorithm is not susceptible to numerical
@@ -228,6 +685,11 @@ ISR_CODE void st_go_idle ()
    Although the AMASS Levels are in reality arbitrary, where the baseline Bresenham counts can
    be multiplied by any integer value, multiplication by powers of two are simply used to ease
    CPU overhead with bitshift integer operations.
+     With STEP_GENERATOR_DDA the same line tracer is run as a digital differential analyzer instead.
+   The counters then hold a per axis phase that wraps at one step (DDA_PHASE_ONE) and the segment
+   generator computes a phase increment per axis and ISR tick for each segment, so every axis steps
+   at its own exact rate. The ISR ticks at the dominant axis step rate, but never slower than
+   STEP_DDA_TICK_RATE, rather than overdriving the timer by the AMASS level.
      This interrupt is simple and dumb by design. All the computational heavy-lifting, as in
    determining accelerations, is performed elsewhere. This interrupt pops pre-computed segments,
    defined as constant velocity over n number of steps, from the step segment buffer and then
@@ -243,35 +705,47 @@ ISR_CODE void st_go_idle ()
 */
 ISR_CODE void stepper_driver_interrupt_handler (void)
 {
-#ifdef ENABLE_BACKLASH_COMPENSATION
-    static bool backlash_motion;
-#endif
-
     // Start a step pulse when there is a block to execute.
-    if(st.exec_block)
-        hal.stepper_pulse_start(&st);
+    if(st.exec_block) {
+        stepper_pulse_start(&st);
+        hooks_dispatch(step_pulse, &st);
+    }
 
     // If there is no step segment, attempt to pop one from the stepper buffer
     if (st.exec_segment == NULL) {
         // Anything in the buffer? If so, load and initialize next step segment.
+      #ifdef INPUT_SHAPING
+        if (shaper.head != segment_buffer_tail) {
+      #else
         if (segment_buffer_head != segment_buffer_tail) {
+      #endif
 
             // Initialize new step segment and load number of steps to execute
             st.exec_segment = &segment_buffer[segment_buffer_tail];
 
             // Initialize step segment timing per step and load number of steps to execute.
-            hal.stepper_cycles_per_tick(st.exec_segment->cycles_per_tick);
+            stepper_cycles_per_tick(st.exec_segment->cycles_per_tick);
             st.step_count = st.exec_segment->n_step; // NOTE: Can sometimes be zero when moving slow.
 
             // If the new segment starts a new planner block, initialize stepper variables and counters.
             if (st.exec_block != st.exec_segment->exec_block) {
 
                 st.exec_block = st.exec_segment->exec_block;
+              #ifdef STEP_GENERATOR_DDA
+                st.step_event_count = DDA_PHASE_ONE; // The DDA counters wrap at one step of phase.
+              #else
                 st.step_event_count = st.exec_block->step_event_count;
+              #endif
                 st.dir_outbits = st.exec_block->direction_bits;
                 st.new_block = true;
 #ifdef ENABLE_BACKLASH_COMPENSATION
-                backlash_motion = st.exec_block->backlash_motion;
+                if(backlash.enabled.mask && sys.state != STATE_HOMING)
+                    backlash_block_start();
+#endif
+
+#ifdef LASER_RASTER_MODE
+                if((raster.line = st.exec_block->raster))
+                    raster_start();
 #endif
 
                 if(st.exec_block->overrides.sync)
@@ -308,11 +782,16 @@ ISR_CODE void stepper_driver_interrupt_handler (void)
                 #endif
                   = st.step_event_count >> 1;
 
-              #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+              #if !(defined(ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING) || defined(STEP_GENERATOR_DDA))
                 memcpy(st.steps, st.exec_block->steps, sizeof(st.steps));
               #endif
             }
 
+          #ifdef STEP_GENERATOR_DDA
+            // Load the per axis phase increments of the segment.
+            memcpy(st.steps, st.exec_segment->dda_rate, sizeof(st.steps));
+          #endif
+
           #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
             // With AMASS enabled, adjust Bresenham axis increment counters according to AMASS level.
             st.amass_level = st.exec_segment->amass_level;
@@ -337,7 +816,30 @@ ISR_CODE void stepper_driver_interrupt_handler (void)
                 hal.spindle_update_rpm(st.exec_segment->spindle_rpm);
               #endif
             }
+
+          #ifdef LASER_POWER_RATE_SYNC
+            if((laser_ramp.delta = st.exec_segment->pwm_delta)) {
+                laser_ramp.pwm = (int32_t)st.exec_segment->spindle_pwm << 8;
+                laser_ramp.ticks = LASER_POWER_RATE_SYNC_TICKS;
+            }
+          #endif
+
+          #ifdef SPECIALIZED_STEPPER_ISR
+            stepper_isr_select();
+          #endif
         } else {
+          #ifdef ENABLE_STEPPER_TELEMETRY
+            // Buffer ran dry with motion pending: the foreground process did not keep up.
+            // If the planner ran empty before that and the segment generator has not yet loaded a
+            // new block it is the input stream or the parser that is lagging, else segment preparation.
+            if(!sys.step_control.end_motion && plan_get_current_block() != NULL) {
+                if(planner_starved)
+                    telemetry.starved_underruns++;
+                else
+                    telemetry.underruns++;
+                telemetry.last_underrun = hal.get_elapsed_ticks ? hal.get_elapsed_ticks() : 0;
+            }
+          #endif
             // Segment buffer empty. Shutdown.
             st_go_idle();
             // Ensure pwm is set properly upon completion of rate-controlled motion.
@@ -356,78 +858,34 @@ ISR_CODE void stepper_driver_interrupt_handler (void)
     if (sys_probe_state == Probe_Active && hal.probe_get_state()) {
         sys_probe_state = Probe_Off;
         memcpy(sys_probe_position, sys_position, sizeof(sys_position));
-        bit_true(sys_rt_exec_state, EXEC_MOTION_CANCEL);
+        system_set_exec_state_flag(EXEC_MOTION_CANCEL);
     }
 
     register axes_signals_t step_outbits = (axes_signals_t){0};
 
-    // Execute step displacement profile by Bresenham line algorithm
-
-    st.counter_x += st.steps[X_AXIS];
-    if (st.counter_x > st.step_event_count) {
-        step_outbits.x = On;
-        st.counter_x -= st.step_event_count;
-#ifdef ENABLE_BACKLASH_COMPENSATION
-        if(!backlash_motion)
-#endif
-            sys_position[X_AXIS] = sys_position[X_AXIS] + (st.dir_outbits.x ? -1 : 1);
-    }
-
-    st.counter_y += st.steps[Y_AXIS];
-    if (st.counter_y > st.step_event_count) {
-        step_outbits.y = On;
-        st.counter_y -= st.step_event_count;
 #ifdef ENABLE_BACKLASH_COMPENSATION
-        if(!backlash_motion)
-#endif
-            sys_position[Y_AXIS] = sys_position[Y_AXIS] + (st.dir_outbits.y ? -1 : 1);
+    // Hold back the line tracer for a tick when backlash is to be taken up on an axis stepped on every tick.
+    // NOTE: Not when homing, backlash steps are not subject to the homing axis lock.
+    if(backlash.pending.mask && sys.state != STATE_HOMING && backlash_hold()) {
+        st.step_outbits.mask = backlash_step(backlash.pending).mask;
+        return;
     }
-
-    st.counter_z += st.steps[Z_AXIS];
-    if (st.counter_z > st.step_event_count) {
-        step_outbits.z = On;
-        st.counter_z -= st.step_event_count;
-#ifdef ENABLE_BACKLASH_COMPENSATION
-        if(!backlash_motion)
 #endif
-            sys_position[Z_AXIS] = sys_position[Z_AXIS] + (st.dir_outbits.z ? -1 : 1);
-    }
 
-  #ifdef A_AXIS
-      st.counter_a += st.steps[A_AXIS];
-      if (st.counter_a > st.step_event_count) {
-          step_outbits.a = On;
-          st.counter_a -= st.step_event_count;
-#ifdef ENABLE_BACKLASH_COMPENSATION
-        if(!backlash_motion)
-#endif
-              sys_position[A_AXIS] = sys_position[A_AXIS] + (st.dir_outbits.a ? -1 : 1);
-      }
-  #endif
+    // Execute step displacement profile by Bresenham line algorithm
+    step_outbits = line_trace(N_AXIS);
 
-  #ifdef B_AXIS
-      st.counter_b += st.steps[B_AXIS];
-      if (st.counter_b > st.step_event_count) {
-          step_outbits.b = On;
-          st.counter_b -= st.step_event_count;
-#ifdef ENABLE_BACKLASH_COMPENSATION
-        if(!backlash_motion)
+#ifdef LASER_RASTER_MODE
+    // Update laser power when the tracking axis steps across a pixel boundary.
+    if(raster.line && (step_outbits.mask & raster.axis.mask) && --raster.steps == 0)
+        raster_next_pixel();
 #endif
-              sys_position[B_AXIS] = sys_position[B_AXIS] + (st.dir_outbits.b ? -1 : 1);
-      }
-  #endif
 
-  #ifdef C_AXIS
-      st.counter_c += st.steps[C_AXIS];
-      if (st.counter_c > st.step_event_count) {
-          step_outbits.c = On;
-          st.counter_c -= st.step_event_count;
 #ifdef ENABLE_BACKLASH_COMPENSATION
-        if(!backlash_motion)
+    // Take up backlash on axes not stepped by the line tracer this tick.
+    if(backlash.pending.mask && sys.state != STATE_HOMING)
+        step_outbits.mask |= backlash_step((axes_signals_t){backlash.pending.mask & ~step_outbits.mask}).mask;
 #endif
-              sys_position[C_AXIS] = sys_position[C_AXIS] + (st.dir_outbits.c ? -1 : 1);
-      }
-  #endif
 
     st.step_outbits.value = step_outbits.value;
 
@@ -435,10 +893,18 @@ ISR_CODE void stepper_driver_interrupt_handler (void)
     if (sys.state == STATE_HOMING)
         st.step_outbits.value &= sys.homing_axis_lock.mask;
 
+#ifdef LASER_POWER_RATE_SYNC
+    // Update laser power along the segment velocity ramp.
+    if(laser_ramp.delta && --laser_ramp.ticks == 0) {
+        laser_ramp.ticks = LASER_POWER_RATE_SYNC_TICKS;
+        laser_ramp.pwm += laser_ramp.delta;
+        hal.spindle_update_pwm((uint_fast16_t)(laser_ramp.pwm >> 8));
+    }
+#endif
+
     if (st.step_count == 0 || --st.step_count == 0) {
         // Segment is complete. Discard current segment and advance segment indexing.
-        st.exec_segment = NULL;
-        segment_buffer_tail = segment_buffer_tail == (SEGMENT_BUFFER_SIZE - 1) ? 0 : segment_buffer_tail + 1;
+        segment_complete();
     }
 }
 
@@ -451,6 +917,19 @@ void st_reset ()
     // Initialize stepper driver idle state, clear step and direction port pins.
     hal.stepper_go_idle(true);
 
+  #ifdef SPECIALIZED_STEPPER_ISR
+    // A specialized ISR may be left installed when a segment is aborted.
+    hal.stepper_interrupt_callback = stepper_driver_interrupt_handler;
+  #endif
+
+  #ifdef ENABLE_BACKLASH_COMPENSATION
+    // Drop backlash take-up interrupted by the reset, it must not be output by the next motion, e.g. homing.
+    backlash.pending.mask = 0;
+    memset(backlash.steps_pending, 0, sizeof(backlash.steps_pending));
+  #endif
+
+    st_prep_lock();
+
     // NOTE: buffer indices starts from 1 for simpler driver coding!
 
     // Set up stepper block ringbuffer as circular linked list and add id
@@ -458,8 +937,23 @@ void st_reset ()
     for(idx = 0 ; idx <= SEGMENT_BUFFER_SIZE - 2 ; idx++) {
         st_block_buffer[idx].next = &st_block_buffer[idx == SEGMENT_BUFFER_SIZE - 2 ? 0 : idx + 1];
         st_block_buffer[idx].id = idx + 1;
+      #ifdef LASER_RASTER_MODE
+        raster_release(&st_block_buffer[idx]);
+      #endif
     }
 
+  #ifdef SEGMENT_PREP_IRQ
+    prep_free_released();
+  #endif
+
+  #ifdef LASER_RASTER_MODE
+    raster.line = NULL;
+  #endif
+
+  #ifdef LASER_POWER_RATE_SYNC
+    laser_ramp.delta = 0;
+  #endif
+
     // Add id to segment buffer enteries
     for(idx = 0 ; idx <= SEGMENT_BUFFER_SIZE - 1 ; idx++) {
         segment_buffer[idx].id = idx + 1;
@@ -476,6 +970,11 @@ void st_reset ()
     segment_buffer_tail = segment_buffer_head = 0; // empty = tail
     segment_next_head = 1;
 
+#ifdef INPUT_SHAPING
+    shaper.head = 0;
+    shaper_reset();
+#endif
+
 #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
     // TODO: move to driver?
     // AMASS_LEVEL0: Normal operation. No AMASS. No upper cutoff frequency. Starts at LEVEL1 cutoff frequency.
@@ -486,6 +985,68 @@ void st_reset ()
 #endif
 
     cycles_per_min = (float)hal.f_step_timer * 60.0f;
+
+    st_prep_unlock();
+}
+
+#ifdef ENABLE_STEPPER_TELEMETRY
+
+st_telemetry_t *st_get_telemetry (void)
+{
+    return &telemetry;
+}
+
+void st_reset_telemetry (void)
+{
+    memset(&telemetry, 0, sizeof(st_telemetry_t));
+    telemetry.min_segments = SEGMENT_BUFFER_SIZE - 1;
+    buffered_time_sampled = planner_starved = false;
+}
+
+// Tracks minimum segment buffer depth while streaming. Called on each segment buffer refill.
+// NOTE: An empty buffer is only recorded when the stepper ISR is executing, not at cycle start.
+inline static uint_fast8_t telemetry_sample_depth (void)
+{
+    uint_fast8_t tail = segment_buffer_tail,
+                 depth = segment_buffer_head >= tail ? segment_buffer_head - tail : SEGMENT_BUFFER_SIZE - tail + segment_buffer_head;
+
+    if(depth < telemetry.min_segments && (depth || st.exec_segment))
+        telemetry.min_segments = depth;
+
+    return depth;
+}
+
+// Tracks minimum motion time queued in the segment and planner buffers. Called when a new planner block is loaded.
+static void telemetry_sample_buffered_time (void)
+{
+    uint32_t ms = st_get_buffered_time() / 1000 + (uint32_t)(plan_get_buffered_time() * 60000.0f);
+
+    if(!buffered_time_sampled || ms < telemetry.min_buffered_ms) {
+        telemetry.min_buffered_ms = ms;
+        buffered_time_sampled = true;
+    }
+}
+
+#endif
+
+// Returns the motion time queued in the segment buffer in microseconds, excluding the executing segment.
+// Used by the foreground task scheduler as the deadline for segment preparation.
+uint32_t st_get_buffered_time (void)
+{
+    float cycles = 0.0f;
+    uint_fast8_t idx = segment_buffer_tail;
+  #ifdef INPUT_SHAPING
+    uint_fast8_t head = shaper.head;
+  #else
+    uint_fast8_t head = segment_buffer_head;
+  #endif
+
+    if(idx != head) {
+        while((idx = idx == (SEGMENT_BUFFER_SIZE - 1) ? 0 : idx + 1) != head)
+            cycles += (float)segment_buffer[idx].n_step * (float)segment_buffer[idx].cycles_per_tick;
+    }
+
+    return (uint32_t)(cycles * 1000000.0f / (float)hal.f_step_timer);
 }
 
 // Called by spindle_set_state() to inform about RPM changes.
@@ -498,16 +1059,22 @@ void st_rpm_changed (float rpm)
 // Called by planner_recalculate() when the executing block is updated by the new plan.
 void st_update_plan_block_parameters ()
 {
+    st_prep_lock();
+
     if (pl_block != NULL) { // Ignore if at start of a new block.
         prep.recalculate.velocity_profile = On;
         pl_block->entry_speed_sqr = prep.current_speed * prep.current_speed; // Update entry speed.
         pl_block = NULL; // Flag st_prep_segment() to load and check active velocity profile.
     }
+
+    st_prep_unlock();
 }
 
 // Changes the run state of the step segment buffer to execute the special parking motion.
 void st_parking_setup_buffer()
 {
+    st_prep_lock();
+
     // Store step execution data of partially completed block, if necessary.
     if (prep.recalculate.hold_partial_block) {
         prep.last_st_block = st_prep_block;
@@ -519,12 +1086,16 @@ void st_parking_setup_buffer()
     prep.recalculate.parking = On;
     prep.recalculate.velocity_profile = Off;
     pl_block = NULL; // Always reset parking motion to reload new block.
+
+    st_prep_unlock();
 }
 
 
 // Restores the step segment buffer to the normal run state after a parking motion.
 void st_parking_restore_buffer()
 {
+    st_prep_lock();
+
     // Restore step execution data and flags of partially completed block, if necessary.
     if (prep.recalculate.hold_partial_block) {
         st_prep_block = prep.last_st_block;
@@ -538,6 +1109,564 @@ void st_parking_restore_buffer()
         prep.recalculate.flags = 0;
 
     pl_block = NULL; // Set to reload next block.
+
+    st_prep_unlock();
+}
+
+#ifdef STEP_GENERATOR_DDA
+
+// Returns the DDA phase of an axis with steps steps in a block when the dominant axis is at step_pos.
+static inline uint64_t dda_phase (uint32_t steps, uint32_t step_event_count, uint32_t step_pos)
+{
+    uint64_t q = (uint64_t)steps * step_pos;
+
+    return ((q / step_event_count) << DDA_PHASE_BITS) + (((q % step_event_count) << DDA_PHASE_BITS) / step_event_count);
+}
+
+// Sets the number of ISR ticks, the timer cycles per tick and the per axis phase increments for a
+// segment advancing the axis phases by phase[] in dt (min). Ticks at least once per dominant axis step
+// and no slower than STEP_DDA_TICK_RATE. Increments are rounded up, the phase is then slightly ahead but
+// since blocks start at half a step of phase no step is gained or lost over a block.
+static void dda_set_rate (segment_t *segment, uint64_t *phase, float dt)
+{
+    uint_fast8_t idx = N_AXIS;
+    uint64_t phase_max = 0;
+
+    do {
+        idx--;
+        phase_max = max(phase_max, phase[idx]);
+    } while(idx);
+
+    uint32_t ticks = max((uint32_t)((phase_max + DDA_PHASE_ONE - 1) >> DDA_PHASE_BITS), (uint32_t)ceilf(dt * (STEP_DDA_TICK_RATE * 60.0f)));
+
+    if(ticks == 0)
+        ticks = 1;
+
+    idx = N_AXIS;
+    do {
+        idx--;
+        segment->dda_rate[idx] = (uint32_t)((phase[idx] + ticks - 1) / ticks);
+    } while(idx);
+
+    segment->n_step = (uint_fast16_t)ticks;
+    segment->cycles_per_tick = (uint32_t)ceilf(cycles_per_min * dt / (float)ticks);
+}
+
+// Sets up DDA execution of the dominant axis steps step_pos to step_pos + n_step of the segment block in dt (min).
+static void dda_prep_segment (segment_t *segment, uint32_t step_pos, uint32_t n_step, float dt)
+{
+    uint_fast8_t idx = N_AXIS;
+    uint64_t phase[N_AXIS];
+    st_block_t *block = segment->exec_block;
+
+    do {
+        idx--;
+        phase[idx] = dda_phase(block->steps[idx], block->step_event_count, step_pos + n_step) -
+                      dda_phase(block->steps[idx], block->step_event_count, step_pos);
+    } while(idx);
+
+    dda_set_rate(segment, phase, dt);
+}
+
+#endif
+
+#ifdef INPUT_SHAPING
+
+// Sets up the path shaper from the per axis shaper settings. Shapers of different axes are combined
+// by convolution, an axis shaper that would exceed INPUT_SHAPER_MAX_IMPULSES is ignored.
+void st_shaper_init (void)
+{
+    uint_fast8_t idx, i, j, n, n_axis, n_impulses = 1;
+    float a[INPUT_SHAPER_MAX_IMPULSES], t[INPUT_SHAPER_MAX_IMPULSES], axis_a[3], axis_t[3], k, td, damping;
+
+    a[0] = 1.0f;
+    t[0] = 0.0f;
+
+    for(idx = 0; idx < N_AXIS; idx++) {
+
+        input_shaper_settings_t *cfg = &settings.shaper[idx];
+
+        if(cfg->frequency <= 0.0f)
+            continue;
+
+        // Skip axes with the same shaper as a previous axis.
+        for(i = 0; i < idx && memcmp(cfg, &settings.shaper[i], sizeof(input_shaper_settings_t)); i++);
+        if(i < idx)
+            continue;
+
+        damping = sqrtf(1.0f - cfg->damping * cfg->damping);
+        k = expf(-cfg->damping * (float)M_PI / damping);
+        td = 1.0f / (cfg->frequency * damping); // Damped period of vibration (s)
+
+        axis_t[0] = 0.0f;
+        axis_t[1] = 0.5f * td;
+        axis_t[2] = td;
+
+        switch(cfg->type) {
+
+            case Shaper_ZVD:
+                axis_a[0] = 1.0f;
+                axis_a[1] = 2.0f * k;
+                axis_a[2] = k * k;
+                n_axis = 3;
+                break;
+
+            case Shaper_EI:
+                axis_a[0] = 0.25f * (1.0f + INPUT_SHAPER_EI_VTOL);
+                axis_a[1] = 0.5f * (1.0f - INPUT_SHAPER_EI_VTOL) * k;
+                axis_a[2] = axis_a[0] * k * k;
+                n_axis = 3;
+                break;
+
+            default: // Shaper_ZV
+                axis_a[0] = 1.0f;
+                axis_a[1] = k;
+                n_axis = 2;
+                break;
+        }
+
+        if(n_impulses * n_axis > INPUT_SHAPER_MAX_IMPULSES)
+            continue;
+
+        // Convolve with the impulses of the combined shaper so far, last to first to allow in place update.
+        n = n_impulses * n_axis;
+        i = n_impulses;
+        do {
+            i--;
+            j = n_axis;
+            do {
+                j--;
+                a[i * n_axis + j] = a[i] * axis_a[j];
+                t[i * n_axis + j] = t[i] + axis_t[j];
+            } while(j);
+        } while(i);
+        n_impulses = n;
+    }
+
+    // Normalize amplitudes to a sum of one.
+    for(k = 0.0f, i = 0; i < n_impulses; i++)
+        k += a[i];
+
+    shaper.t_max = 0.0f;
+    for(i = 0; i < n_impulses; i++) {
+        shaper.a[i] = a[i] / k;
+        shaper.t[i] = t[i];
+        shaper.t_max = max(shaper.t_max, t[i]);
+    }
+
+    shaper.n_impulses = n_impulses > 1 ? n_impulses : 0;
+}
+
+// Returns the unshaped path distance at time t, interpolated from the time line.
+static float shaper_distance (float t)
+{
+    uint_fast8_t lo = 0, hi = shaper.n_points - 1, mid;
+
+    if(t <= shaper.point[0].t)
+        return shaper.point[0].s;
+
+    if(t >= shaper.point[hi].t)
+        return shaper.point[hi].s; // Stopped after the last segment.
+
+    while(hi - lo > 1) {
+        mid = (lo + hi) >> 1;
+        if(shaper.point[mid].t < t)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    return shaper.point[lo].s + (shaper.point[hi].s - shaper.point[lo].s) * (t - shaper.point[lo].t) / (shaper.point[hi].t - shaper.point[lo].t);
+}
+
+// Returns the shaped path distance at time t, the sum of the impulse weighted delayed unshaped distances.
+static float shaper_position (float t)
+{
+    uint_fast8_t idx = shaper.n_impulses;
+    float s = 0.0f;
+
+    do {
+        idx--;
+        s += shaper.a[idx] * shaper_distance(t - shaper.t[idx]);
+    } while(idx);
+
+    return s;
+}
+
+// Returns the highest unshaped speed in the part of the time line the shaped motion depends on.
+static float shaper_max_speed (void)
+{
+    uint_fast8_t idx;
+    float dt, v_max = 0.0f;
+
+    for(idx = 1; idx < shaper.n_points; idx++) {
+        if(shaper.point[idx].t > shaper.t_shaped - shaper.t_max && (dt = shaper.point[idx].t - shaper.point[idx - 1].t) > 0.0f)
+            v_max = max(v_max, (shaper.point[idx].s - shaper.point[idx - 1].s) / dt);
+    }
+
+    return v_max;
+}
+
+// Drops time line points no longer needed, the remaining points are rebased to the oldest.
+static void shaper_trim (bool force)
+{
+    uint_fast8_t idx, n = 0;
+
+    while(shaper.n_points - shaper.n_pending - n > 1 && (force || shaper.point[n + 1].t <= shaper.t_shaped - shaper.t_max)) {
+        n++;
+        force = false;
+    }
+
+    if(n) {
+        float t0 = shaper.point[n].t, s0 = shaper.point[n].s;
+        shaper.n_points -= n;
+        for(idx = 0; idx < shaper.n_points; idx++) {
+            shaper.point[idx].t = shaper.point[idx + n].t - t0;
+            shaper.point[idx].s = shaper.point[idx + n].s - s0;
+        }
+        shaper.t_shaped -= t0;
+    }
+}
+
+// Sets the segment step rate for the shaped segment duration (s).
+static void shaper_set_duration (segment_t *segment, float duration)
+{
+  #ifdef STEP_GENERATOR_DDA
+
+    // Spread the phase advance of the segment over the ticks for the new duration.
+    uint_fast8_t idx = N_AXIS;
+    uint64_t phase[N_AXIS];
+   #ifdef LASER_POWER_RATE_SYNC
+    uint32_t ticks = segment->n_step;
+   #endif
+
+    do {
+        idx--;
+        phase[idx] = (uint64_t)segment->dda_rate[idx] * segment->n_step;
+    } while(idx);
+
+    dda_set_rate(segment, phase, duration / 60.0f);
+
+   #ifdef LASER_POWER_RATE_SYNC
+    // Rescale laser power ramp to the new number of ISR ticks.
+    if(segment->pwm_delta && ticks != segment->n_step) {
+        int32_t updates = (int32_t)(segment->n_step / LASER_POWER_RATE_SYNC_TICKS);
+        segment->pwm_delta = updates ? segment->pwm_delta * (int32_t)(ticks / LASER_POWER_RATE_SYNC_TICKS) / updates : 0;
+    }
+   #endif
+
+  #else
+
+    uint32_t cycles, n_step = segment->n_step;
+
+  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    n_step >>= segment->amass_level;
+  #endif
+
+    if(n_step == 0)
+        return;
+
+    cycles = (uint32_t)ceilf((float)hal.f_step_timer * duration / (float)n_step);
+
+  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    if (cycles < amass.level_1)
+        segment->amass_level = 0;
+    else {
+        segment->amass_level = cycles < amass.level_2 ? 1 : (cycles < amass.level_3 ? 2 : 3);
+        cycles >>= segment->amass_level;
+        n_step <<= segment->amass_level;
+    }
+  #endif
+
+  #ifdef LASER_POWER_RATE_SYNC
+    // Rescale laser power ramp to the new number of ISR ticks.
+    if(segment->pwm_delta && n_step != segment->n_step) {
+        int32_t updates = (int32_t)(n_step / LASER_POWER_RATE_SYNC_TICKS);
+        segment->pwm_delta = updates ? segment->pwm_delta * (int32_t)(segment->n_step / LASER_POWER_RATE_SYNC_TICKS) / updates : 0;
+    }
+  #endif
+
+    segment->n_step = (uint_fast16_t)n_step;
+    segment->cycles_per_tick = cycles;
+
+  #endif
+}
+
+// Releases pending segments to the stepper ISR when their shaped timing can be determined, that is when the
+// time line extends far enough for the shaped motion to reach the segment end. When flushing the motion is
+// taken to stop after the last segment.
+static void shaper_release (bool flush)
+{
+    uint_fast8_t idx;
+    float t_end, lo, hi, v_max = -1.0f;
+    shaper_point_t *start, *end;
+
+    while(shaper.n_pending) {
+
+        idx = shaper.n_points - shaper.n_pending;
+        start = &shaper.point[idx - 1];
+        end = &shaper.point[idx];
+
+        if(end->s <= start->s)
+            t_end = shaper.t_shaped + end->t - start->t; // No motion (dwell), keep duration.
+        else {
+            lo = shaper.t_shaped;
+            hi = shaper.point[shaper.n_points - 1].t;
+            if(flush || (segment_next_head == segment_buffer_tail && shaper.head == segment_buffer_tail))
+                hi += shaper.t_max; // Flushing, or buffer full of pending segments and the ISR is starved.
+            else if(shaper_position(hi) < end->s)
+                break; // Shaped motion depends on segments not yet prepped.
+
+            // Bisect for the time the shaped motion reaches the end of the segment.
+            idx = 16;
+            do {
+                t_end = 0.5f * (lo + hi);
+                if(shaper_position(t_end) < end->s)
+                    lo = t_end;
+                else
+                    hi = t_end;
+            } while(--idx);
+
+            // Shaped speed cannot exceed the unshaped speeds it is derived from.
+            if(v_max < 0.0f)
+                v_max = shaper_max_speed();
+            t_end = v_max > 0.0f ? max(hi, shaper.t_shaped + (end->s - start->s) / v_max) : hi;
+
+            shaper_set_duration(&segment_buffer[shaper.head], t_end - shaper.t_shaped);
+        }
+
+        shaper.t_shaped = t_end;
+        shaper.n_pending--;
+        shaper.head = shaper.head == (SEGMENT_BUFFER_SIZE - 1) ? 0 : shaper.head + 1;
+    }
+
+    shaper_trim(false);
+}
+
+// Adds a committed segment to the unshaped time line, distance is the path length of the segment (mm).
+// Segments of spindle synchronized and homing motions are released unshaped after any pending segments.
+static void shaper_push (segment_t *segment, float distance)
+{
+    bool bypass = shaper.n_impulses == 0 || pl_block->condition.spindle.synchronized || sys.state == STATE_HOMING;
+    float duration = (float)segment->n_step * (float)segment->cycles_per_tick / (float)hal.f_step_timer;
+
+    if(bypass && shaper.n_pending)
+        shaper_release(true);
+
+    if(shaper.n_points == INPUT_SHAPER_HISTORY)
+        shaper_trim(true);
+
+    shaper.point[shaper.n_points].t = shaper.point[shaper.n_points - 1].t + duration;
+    shaper.point[shaper.n_points].s = shaper.point[shaper.n_points - 1].s + distance;
+    shaper.n_points++;
+
+    if(bypass) {
+        shaper.t_shaped += duration;
+        shaper.head = shaper.head == (SEGMENT_BUFFER_SIZE - 1) ? 0 : shaper.head + 1;
+        shaper_trim(false);
+    } else {
+        shaper.n_pending++;
+        shaper_release(false);
+    }
+}
+
+#endif
+
+#ifdef KINEMATICS_API
+
+// Converts the end position of a cartesian_motion segment to motor steps and sets up the stepper block
+// data for it, each segment is executed as a straight line in motor space by the Bresenham algorithm.
+// Returns false if the segment was not generated due to the end of a feed hold.
+static bool kinematics_prep_segment (segment_t *prep_segment, float mm_remaining, float dt)
+{
+    uint_fast8_t idx = N_AXIS;
+    uint32_t steps[N_AXIS], n_step = 0;
+    int32_t target_steps[N_AXIS];
+    float target[N_AXIS], distance = mm_remaining * prep.kin_inv_mm;
+    axes_signals_t direction_bits = {0};
+
+    do {
+        idx--;
+        target[idx] = pl_block->cartesian_target[idx] - (pl_block->cartesian_target[idx] - pl_block->cartesian_start[idx]) * distance;
+    } while(idx);
+
+    kinematics.segment_target_to_steps(target_steps, target);
+
+    idx = N_AXIS;
+    do {
+        idx--;
+        steps[idx] = labs(target_steps[idx] - prep.kin_steps[idx]);
+        n_step = max(n_step, steps[idx]);
+        if(target_steps[idx] < prep.kin_steps[idx])
+            direction_bits.mask |= bit(idx);
+    } while(idx);
+
+  #ifdef INPUT_SHAPING
+    float shaper_mm = pl_block->millimeters - mm_remaining;
+  #endif
+
+    pl_block->millimeters = mm_remaining;
+    prep.steps_remaining = (uint32_t)ceilf(prep.steps_per_mm * mm_remaining);
+
+    if(n_step == 0) {
+        if(sys.step_control.execute_hold) {
+            // Less than one step to decelerate to zero speed, just bail.
+            sys.step_control.end_motion = On;
+            if (settings.parking.flags.enabled && !prep.recalculate.parking)
+                prep.recalculate.hold_partial_block = On;
+            return false;
+        }
+        // No motor steps in segment, carry the execution time over to the next segment.
+        prep.dt_remainder += dt;
+        return true;
+    }
+
+    // The first segment reuses the stepper block set up on block load, the following segments
+    // start new stepper blocks so that the stepper ISR reinitializes the Bresenham counters.
+    if(prep.kin_first)
+        prep.kin_first = false;
+    else {
+        st_block_t *prev_block = st_prep_block;
+        st_prep_block = st_prep_block->next;
+      #ifdef LASER_RASTER_MODE
+        raster_release(st_prep_block);
+      #endif
+        st_prep_block->programmed_rate = prev_block->programmed_rate;
+        st_prep_block->millimeters = prev_block->millimeters;
+        st_prep_block->steps_per_mm = prev_block->steps_per_mm;
+        st_prep_block->overrides = prev_block->overrides;
+        st_prep_block->dynamic_rpm = prev_block->dynamic_rpm;
+        st_prep_block->message = NULL;
+        st_prep_block->output_commands = NULL;
+    }
+
+  #ifdef STEP_GENERATOR_DDA
+    memcpy(st_prep_block->steps, steps, sizeof(st_prep_block->steps));
+    st_prep_block->step_event_count = n_step;
+  #else
+    idx = N_AXIS;
+    do {
+        idx--;
+      #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+        st_prep_block->steps[idx] = steps[idx] << 1;
+      #else
+        st_prep_block->steps[idx] = steps[idx] << MAX_AMASS_LEVEL;
+      #endif
+    } while(idx);
+  #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    st_prep_block->step_event_count = n_step << 1;
+  #else
+    st_prep_block->step_event_count = n_step << MAX_AMASS_LEVEL;
+  #endif
+  #endif
+    st_prep_block->direction_bits = direction_bits;
+  #ifdef SPECIALIZED_STEPPER_ISR
+    st_prep_block->traced_axes = traced_axes(steps);
+  #endif
+
+    memcpy(prep.kin_steps, target_steps, sizeof(prep.kin_steps));
+
+    prep_segment->exec_block = st_prep_block;
+    prep_segment->n_step = (uint_fast16_t)n_step;
+    prep_segment->spindle_sync = false;
+
+  #ifdef STEP_GENERATOR_DDA
+    // Segment steps are exact, no partial step time to carry over.
+    dda_prep_segment(prep_segment, 0, n_step, dt + prep.dt_remainder);
+    prep.dt_remainder = 0.0f;
+  #else
+    // Segment steps are exact, no partial step time to carry over.
+    uint32_t cycles = (uint32_t)ceilf(cycles_per_min * (dt + prep.dt_remainder) / (float)n_step); // (cycles/step)
+    prep.dt_remainder = 0.0f;
+
+  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    if (cycles < amass.level_1)
+        prep_segment->amass_level = 0;
+    else {
+        prep_segment->amass_level = cycles < amass.level_2 ? 1 : (cycles < amass.level_3 ? 2 : 3);
+        cycles >>= prep_segment->amass_level;
+        prep_segment->n_step <<= prep_segment->amass_level;
+    }
+  #endif
+
+    prep_segment->cycles_per_tick = cycles;
+  #endif
+
+    // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
+    segment_buffer_head = segment_next_head;
+    segment_next_head = segment_next_head == (SEGMENT_BUFFER_SIZE - 1) ? 0 : segment_next_head + 1;
+
+  #ifdef INPUT_SHAPING
+    shaper_push(prep_segment, shaper_mm);
+  #endif
+
+    return true;
+}
+
+#endif
+
+// Sets up stepper block data for a dwell, a block with no steps to execute.
+static void dwell_prep_block (void)
+{
+    st_block_t *prev_block = st_prep_block;
+
+    st_prep_block = st_prep_block->next;
+#ifdef LASER_RASTER_MODE
+    raster_release(st_prep_block);
+#endif
+
+    memset(st_prep_block->steps, 0, sizeof(st_prep_block->steps));
+    st_prep_block->step_event_count = 1;
+    st_prep_block->direction_bits = prev_block->direction_bits; // Keep direction outputs unchanged.
+  #ifdef SPECIALIZED_STEPPER_ISR
+    st_prep_block->traced_axes = 1;
+  #endif
+    st_prep_block->programmed_rate = st_prep_block->millimeters = st_prep_block->steps_per_mm = 0.0f;
+    st_prep_block->message = pl_block->message;
+    st_prep_block->output_commands = pl_block->output_commands;
+    st_prep_block->overrides = pl_block->overrides;
+    st_prep_block->dynamic_rpm = false;
+
+    prep.current_speed = 0.0f;
+}
+
+// Generates a segment of the current dwell block. Dwell segments execute ticks without
+// step output at 1 kHz, up to DT_SEGMENT in length.
+// Returns false if the segment was not generated due to a feed hold.
+static bool dwell_prep_segment (segment_t *prep_segment)
+{
+    if (sys.step_control.execute_hold) {
+        sys.step_control.end_motion = On;
+        if (settings.parking.flags.enabled && !prep.recalculate.parking)
+            prep.recalculate.hold_partial_block = On;
+        return false;
+    }
+
+    float dt = min(pl_block->dwell, DT_SEGMENT);
+    uint32_t n_ticks = (uint32_t)ceilf(dt * 60000.0f);
+
+    if (n_ticks == 0)
+        n_ticks = 1;
+
+    prep_segment->n_step = (uint_fast16_t)n_ticks;
+    prep_segment->cycles_per_tick = (uint32_t)ceilf(cycles_per_min * dt / (float)n_ticks);
+    prep_segment->spindle_sync = false;
+    prep_segment->amass_level = 0;
+  #ifdef STEP_GENERATOR_DDA
+    memset(prep_segment->dda_rate, 0, sizeof(prep_segment->dda_rate));
+  #endif
+
+    pl_block->dwell -= dt;
+
+    // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
+    segment_buffer_head = segment_next_head;
+    segment_next_head = segment_next_head == (SEGMENT_BUFFER_SIZE - 1) ? 0 : segment_next_head + 1;
+
+  #ifdef INPUT_SHAPING
+    shaper_push(prep_segment, 0.0f);
+  #endif
+
+    return true;
 }
 
 /* Prepares step segment buffer. Continuously called from main program.
@@ -553,12 +1682,41 @@ void st_parking_restore_buffer()
    Currently, the segment buffer conservatively holds roughly up to 40-50 msec of steps.
    NOTE: Computation units are in steps, millimeters, and minutes.
 */
-void st_prep_buffer()
+#ifdef INPUT_SHAPING
+
+static void prep_segments (void);
+
+// Reloads step segment buffer and releases input shaped segments to the stepper ISR.
+static void prep_buffer (void)
+{
+    // Start a new time line when motion has stopped.
+    if (shaper.n_pending == 0 && shaper.head == segment_buffer_tail && st.exec_segment == NULL)
+        shaper_reset();
+
+    prep_segments();
+
+    // Release all pending segments when no more are to be prepped.
+    if (shaper.n_pending && (sys.step_control.end_motion || (pl_block == NULL && plan_get_current_block() == NULL)))
+        shaper_release(true);
+}
+
+static void prep_segments (void)
+#else
+static void prep_buffer (void)
+#endif
 {
     // Block step prep buffer, while in a suspend state and there is no suspend motion to execute.
     if (sys.step_control.end_motion)
         return;
 
+#ifdef ENABLE_STEPPER_TELEMETRY
+    uint_fast8_t depth = 0;
+    bool streaming = sys.state == STATE_CYCLE && !sys.step_control.execute_sys_motion;
+
+    if(streaming && (pl_block || plan_get_current_block()))
+        depth = telemetry_sample_depth();
+#endif
+
     while (segment_buffer_tail != segment_next_head) { // Check if we need to fill the buffer.
 
         // Determine if we need to load a new planner block or if the block needs to be recomputed.
@@ -568,8 +1726,33 @@ void st_prep_buffer()
 
             pl_block = sys.step_control.execute_sys_motion ? plan_get_system_motion_block() : plan_get_current_block();
 
-            if (pl_block == NULL)
+            if (pl_block == NULL) {
+              #ifdef ENABLE_STEPPER_TELEMETRY
+                // Count once per starvation event, segments are still executing.
+                if(streaming && !planner_starved && segment_buffer_head != segment_buffer_tail) {
+                    planner_starved = true;
+                    telemetry.planner_empty++;
+                    telemetry.last_planner_empty = hal.get_elapsed_ticks ? hal.get_elapsed_ticks() : 0;
+                }
+              #endif
                 return; // No planner blocks. Exit.
+            }
+
+          #ifdef ENABLE_STEPPER_TELEMETRY
+            planner_starved = false;
+          #endif
+
+            if (pl_block->condition.dwell) {
+                // Dwell block, no velocity profile to compute.
+                if (prep.recalculate.velocity_profile) {
+                    if (prep.recalculate.parking)
+                        prep.recalculate.velocity_profile = Off;
+                    else
+                        prep.recalculate.flags = 0;
+                } else
+                    dwell_prep_block();
+                continue;
+            }
 
             // Check if we need to only recompute the velocity profile or load a new block.
             if (prep.recalculate.velocity_profile) {
@@ -588,8 +1771,25 @@ void st_prep_buffer()
 
                 st_prep_block = st_prep_block->next;
 
+              #ifdef LASER_RASTER_MODE
+                raster_release(st_prep_block);
+                if((st_prep_block->raster = pl_block->raster)) {
+                    pl_block->raster = NULL;
+                    raster_prep(st_prep_block->raster);
+                }
+              #endif
+
+              #ifdef ENABLE_STEPPER_TELEMETRY
+                if(streaming && (depth || st.exec_segment))
+                    telemetry_sample_buffered_time();
+              #endif
+
+              #if defined(STEP_GENERATOR_DDA)
+                // The DDA phase increments are computed per segment from the unscaled Bresenham data.
+                memcpy(st_prep_block->steps, pl_block->steps, sizeof(st_prep_block->steps));
+                st_prep_block->step_event_count = pl_block->step_event_count;
+              #elif !defined(ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING)
                 uint_fast8_t idx = N_AXIS;
-              #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
                 do {
                     idx--;
                     st_prep_block->steps[idx] = (pl_block->steps[idx] << 1);
@@ -599,6 +1799,7 @@ void st_prep_buffer()
                 // With AMASS enabled, simply bit-shift multiply all Bresenham data by the max AMASS
                 // level, such that we never divide beyond the original data anywhere in the algorithm.
                 // If the original data is divided, we can lose a step from integer roundoff.
+                uint_fast8_t idx = N_AXIS;
                 do {
                     idx--;
                     st_prep_block->steps[idx] = pl_block->steps[idx] << MAX_AMASS_LEVEL;
@@ -607,13 +1808,15 @@ void st_prep_buffer()
               #endif
 
                 st_prep_block->direction_bits = pl_block->direction_bits;
+              #ifdef SPECIALIZED_STEPPER_ISR
+                st_prep_block->traced_axes = traced_axes(pl_block->steps);
+              #endif
                 st_prep_block->programmed_rate = pl_block->programmed_rate;
                 st_prep_block->millimeters = pl_block->millimeters;
                 st_prep_block->steps_per_mm = (float)pl_block->step_event_count / pl_block->millimeters;
                 st_prep_block->message = pl_block->message;
                 st_prep_block->output_commands = pl_block->output_commands;
                 st_prep_block->overrides = pl_block->overrides;
-                st_prep_block->backlash_motion = pl_block->condition.backlash_motion;
 
                 // Initialize segment buffer data for generating the segments.
                 prep.steps_per_mm = st_prep_block->steps_per_mm;
@@ -636,6 +1839,28 @@ void st_prep_buffer()
                     prep.inv_feedrate = pl_block->condition.is_laser_ppi_mode ? 1.0f : 1.0f / pl_block->programmed_rate;
                 else
                     st_prep_block->dynamic_rpm = pl_block->condition.is_rpm_pos_adjusted;
+
+              #ifdef LASER_RASTER_MODE
+                // Ensure the laser is switched off when motion ends with a scanline.
+                st_prep_block->dynamic_rpm |= st_prep_block->raster != NULL;
+              #endif
+
+              #ifdef KINEMATICS_API
+                if(pl_block->condition.cartesian_motion) {
+                    // Motor position at block start is the motor position at the block target less the block steps.
+                    kinematics.segment_target_to_steps(prep.kin_steps, pl_block->cartesian_target);
+                    uint_fast8_t idx = N_AXIS;
+                    do {
+                        idx--;
+                        if(pl_block->direction_bits.mask & bit(idx))
+                            prep.kin_steps[idx] += (int32_t)pl_block->steps[idx];
+                        else
+                            prep.kin_steps[idx] -= (int32_t)pl_block->steps[idx];
+                    } while(idx);
+                    prep.kin_inv_mm = 1.0f / pl_block->millimeters;
+                    prep.kin_first = true;
+                }
+              #endif
             }
 
             /* ---------------------------------------------------------------------------------
@@ -741,6 +1966,21 @@ void st_prep_buffer()
         // Set new segment to point to the current segment data block.
         prep_segment->exec_block = st_prep_block;
         prep_segment->update_rpm = false;
+      #ifdef LASER_POWER_RATE_SYNC
+        prep_segment->pwm_delta = 0;
+        uint_fast16_t pwm_start = 0;
+        bool pwm_ramp = false;
+      #endif
+
+        if (pl_block->condition.dwell) {
+            if (!dwell_prep_segment(prep_segment))
+                return; // Feed hold, remaining dwell time is retained.
+            if (pl_block->dwell <= 0.0f) {
+                pl_block = NULL; // Set pointer to indicate check and load next planner block.
+                plan_discard_current_block();
+            }
+            continue;
+        }
 
         /*------------------------------------------------------------------------------------
             Compute the average velocity of this new segment by determining the total distance
@@ -756,7 +1996,14 @@ void st_prep_buffer()
           the end of planner block (typical) or mid-block at the end of a forced deceleration,
           such as from a feed hold.
         */
+      #ifdef SEGMENT_CRUISE_TICKS_PER_SECOND
+        // Generate longer segments when cruising, unless segment timing is critical.
+        bool cruise_segment = prep.ramp_type == Ramp_Cruise &&
+                               !(sys.step_control.execute_hold || st_prep_block->dynamic_rpm || pl_block->condition.spindle.synchronized);
+        float dt_max = cruise_segment ? DT_SEGMENT_CRUISE : DT_SEGMENT; // Maximum segment time
+      #else
         float dt_max = DT_SEGMENT; // Maximum segment time
+      #endif
         float dt = 0.0f; // Initialize segment time
         float time_var = dt_max; // Time worker variable
         float mm_var; // mm - Distance worker variable
@@ -833,6 +2080,14 @@ void st_prep_buffer()
 
             dt += time_var; // Add computed ramp time to total segment time.
 
+          #ifdef SEGMENT_CRUISE_TICKS_PER_SECOND
+            if(cruise_segment && prep.ramp_type != Ramp_Cruise) {
+                // End of cruise, do not extend segment into the deceleration ramp beyond the normal segment time.
+                cruise_segment = false;
+                dt_max = max(dt, DT_SEGMENT);
+            }
+          #endif
+
             if (dt < dt_max)
                 time_var = dt_max - dt;// **Incomplete** At ramp junction.
             else {
@@ -851,6 +2106,12 @@ void st_prep_buffer()
            Compute spindle spindle speed for step segment
         */
 
+      #ifdef LASER_RASTER_MODE
+        // Laser power is set per pixel by the stepper ISR for scanlines.
+        if (st_prep_block->raster)
+            prep.current_spindle_rpm = -1.0f; // Force update after the scanline.
+        else
+      #endif
         if (sys.step_control.update_spindle_rpm || st_prep_block->dynamic_rpm) {
             float rpm;
             if (pl_block->condition.spindle.on) {
@@ -872,6 +2133,12 @@ void st_prep_buffer()
               #ifdef SPINDLE_PWM_DIRECT
                 prep.current_spindle_rpm = rpm;
                 prep_segment->spindle_pwm = hal.spindle_get_pwm(rpm);
+               #ifdef LASER_POWER_RATE_SYNC
+                // Power set up to ramp from the end of the previous segment when the segment step count is known.
+                pwm_start = prep.current_pwm;
+                pwm_ramp = pl_block->condition.is_rpm_rate_adjusted && !pl_block->condition.is_laser_ppi_mode;
+                prep.current_pwm = prep_segment->spindle_pwm;
+               #endif
               #else
                 prep.current_spindle_rpm = prep_segment->spindle_rpm = rpm;
               #endif
@@ -890,64 +2157,92 @@ void st_prep_buffer()
            Fortunately, this scenario is highly unlikely and unrealistic in CNC machines
            supported by Grbl (i.e. exceeding 10 meters axis travel at 200 step/mm).
         */
-        float step_dist_remaining = prep.steps_per_mm * mm_remaining; // Convert mm_remaining to steps
-        uint32_t n_steps_remaining = (uint32_t)ceilf(step_dist_remaining); // Round-up current steps remaining
+#ifdef KINEMATICS_API
+        if(pl_block->condition.cartesian_motion) {
+            if(!kinematics_prep_segment(prep_segment, mm_remaining, dt))
+                return; // Segment not generated, but current step data still retained.
+        } else
+#endif
+        {
+            float step_dist_remaining = prep.steps_per_mm * mm_remaining; // Convert mm_remaining to steps
+            uint32_t n_steps_remaining = (uint32_t)ceilf(step_dist_remaining); // Round-up current steps remaining
 
-        prep_segment->n_step = (uint_fast16_t)(prep.steps_remaining - n_steps_remaining); // Compute number of steps to execute.
+            prep_segment->n_step = (uint_fast16_t)(prep.steps_remaining - n_steps_remaining); // Compute number of steps to execute.
 
-        // Bail if we are at the end of a feed hold and don't have a step to execute.
-        if (prep_segment->n_step == 0 && sys.step_control.execute_hold) {
-            // Less than one step to decelerate to zero speed, but already very close. AMASS
-            // requires full steps to execute. So, just bail.
-            sys.step_control.end_motion = On;
-            if (settings.parking.flags.enabled && !prep.recalculate.parking)
-                prep.recalculate.hold_partial_block = On;
-            return; // Segment not generated, but current step data still retained.
-        }
+            // Bail if we are at the end of a feed hold and don't have a step to execute.
+            if (prep_segment->n_step == 0 && sys.step_control.execute_hold) {
+                // Less than one step to decelerate to zero speed, but already very close. AMASS
+                // requires full steps to execute. So, just bail.
+                sys.step_control.end_motion = On;
+                if (settings.parking.flags.enabled && !prep.recalculate.parking)
+                    prep.recalculate.hold_partial_block = On;
+                return; // Segment not generated, but current step data still retained.
+            }
 
-        // Compute segment step rate. Since steps are integers and mm distances traveled are not,
-        // the end of every segment can have a partial step of varying magnitudes that are not
-        // executed, because the stepper ISR requires whole steps due to the AMASS algorithm. To
-        // compensate, we track the time to execute the previous segment's partial step and simply
-        // apply it with the partial step distance to the current segment, so that it minutely
-        // adjusts the whole segment rate to keep step output exact. These rate adjustments are
-        // typically very small and do not adversely effect performance, but ensures that Grbl
-        // outputs the exact acceleration and velocity profiles as computed by the planner.
-        dt += prep.dt_remainder; // Apply previous segment partial step execute time
-        float inv_rate = dt / ((float)prep.steps_remaining - step_dist_remaining); // Compute adjusted step rate inverse
-
-        // Compute timer ticks per step for the prepped segment.
-        uint32_t cycles = (uint32_t)ceilf(cycles_per_min * inv_rate); // (cycles/step)
-
-        // Record end position of segment relative to block if spindle synchronized motion
-        if((prep_segment->spindle_sync = pl_block->condition.spindle.synchronized)) {
-            prep.target_position += dt * prep.target_feed;
-            prep_segment->cruising = prep.ramp_type == Ramp_Cruise;
-            prep_segment->target_position = prep.target_position; //st_prep_block->millimeters - pl_block->millimeters;
-        }
+            // Compute segment step rate. Since steps are integers and mm distances traveled are not,
+            // the end of every segment can have a partial step of varying magnitudes that are not
+            // executed, because the stepper ISR requires whole steps due to the AMASS algorithm. To
+            // compensate, we track the time to execute the previous segment's partial step and simply
+            // apply it with the partial step distance to the current segment, so that it minutely
+            // adjusts the whole segment rate to keep step output exact. These rate adjustments are
+            // typically very small and do not adversely effect performance, but ensures that Grbl
+            // outputs the exact acceleration and velocity profiles as computed by the planner.
+            dt += prep.dt_remainder; // Apply previous segment partial step execute time
+            float inv_rate = dt / ((float)prep.steps_remaining - step_dist_remaining); // Compute adjusted step rate inverse
+
+          #ifndef STEP_GENERATOR_DDA
+            // Compute timer ticks per step for the prepped segment.
+            uint32_t cycles = (uint32_t)ceilf(cycles_per_min * inv_rate); // (cycles/step)
+          #endif
+
+            // Record end position of segment relative to block if spindle synchronized motion
+            if((prep_segment->spindle_sync = pl_block->condition.spindle.synchronized)) {
+                prep.target_position += dt * prep.target_feed;
+                prep_segment->cruising = prep.ramp_type == Ramp_Cruise;
+                prep_segment->target_position = prep.target_position; //st_prep_block->millimeters - pl_block->millimeters;
+            }
 
-      #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-        // Compute step timing and multi-axis smoothing level.
-        // NOTE: AMASS overdrives the timer with each level, so only one prescalar is required.
-        if (cycles < amass.level_1)
-            prep_segment->amass_level = 0;
-        else {
-            prep_segment->amass_level = cycles < amass.level_2 ? 1 : (cycles < amass.level_3 ? 2 : 3);
-            cycles >>= prep_segment->amass_level;
-            prep_segment->n_step <<= prep_segment->amass_level;
-        }
-      #endif
+          #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+            // Compute step timing and multi-axis smoothing level.
+            // NOTE: AMASS overdrives the timer with each level, so only one prescalar is required.
+            if (cycles < amass.level_1)
+                prep_segment->amass_level = 0;
+            else {
+                prep_segment->amass_level = cycles < amass.level_2 ? 1 : (cycles < amass.level_3 ? 2 : 3);
+                cycles >>= prep_segment->amass_level;
+                prep_segment->n_step <<= prep_segment->amass_level;
+            }
+          #endif
+
+          #ifdef STEP_GENERATOR_DDA
+            // Compute ISR ticks and per axis phase increments, a segment without steps executes one step time.
+            dda_prep_segment(prep_segment, pl_block->step_event_count - prep.steps_remaining, prep_segment->n_step,
+                              prep_segment->n_step ? inv_rate * (float)prep_segment->n_step : inv_rate);
+          #else
+            prep_segment->cycles_per_tick = cycles;
+          #endif
+
+          #ifdef LASER_POWER_RATE_SYNC
+            uint32_t updates = prep_segment->n_step / LASER_POWER_RATE_SYNC_TICKS;
+            if(pwm_ramp && updates > 0) {
+                prep_segment->pwm_delta = (((int32_t)prep_segment->spindle_pwm - (int32_t)pwm_start) << 8) / (int32_t)updates;
+                prep_segment->spindle_pwm = pwm_start;
+            }
+          #endif
 
-        prep_segment->cycles_per_tick = cycles;
+            // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
+            segment_buffer_head = segment_next_head;
+            segment_next_head = segment_next_head == (SEGMENT_BUFFER_SIZE - 1) ? 0 : segment_next_head + 1;
 
-        // Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
-        segment_buffer_head = segment_next_head;
-        segment_next_head = segment_next_head == (SEGMENT_BUFFER_SIZE - 1) ? 0 : segment_next_head + 1;
+          #ifdef INPUT_SHAPING
+            shaper_push(prep_segment, (float)(prep.steps_remaining - n_steps_remaining) / prep.steps_per_mm);
+          #endif
 
-        // Update the appropriate planner and segment data.
-        pl_block->millimeters = mm_remaining;
-        prep.steps_remaining = n_steps_remaining;
-        prep.dt_remainder = ((float)n_steps_remaining - step_dist_remaining) * inv_rate;
+            // Update the appropriate planner and segment data.
+            pl_block->millimeters = mm_remaining;
+            prep.steps_remaining = n_steps_remaining;
+            prep.dt_remainder = ((float)n_steps_remaining - step_dist_remaining) * inv_rate;
+        }
 
         // Check for exit conditions and flag to load next planner block.
         if (mm_remaining <= prep.mm_complete) {
@@ -974,6 +2269,51 @@ void st_prep_buffer()
     }
 }
 
+#ifdef SEGMENT_PREP_IRQ
+
+static volatile uint_fast8_t prep_lock = 0;
+static volatile bool prep_pending = false;
+
+void st_prep_lock (void)
+{
+    prep_lock++;
+}
+
+void st_prep_unlock (void)
+{
+    if(--prep_lock == 0 && prep_pending) {
+        prep_pending = false;
+        hal.stepper_prep_request();
+    }
+}
+
+// Called from the low priority segment prep interrupt. Preempts the foreground, so the lock cannot change while running.
+void st_prep_irq_handler (void)
+{
+    if(prep_lock)
+        prep_pending = true;
+    else
+        prep_buffer();
+}
+
+// Foreground segment prep, locks out the segment prep interrupt while running.
+void st_prep_buffer (void)
+{
+    st_prep_lock();
+    prep_buffer();
+    prep_free_released();
+    st_prep_unlock();
+}
+
+#else
+
+void st_prep_buffer (void)
+{
+    prep_buffer();
+}
+
+#endif
+
 
 // Called by realtime status reporting to fetch the current speed being executed. This value
 // however is not exactly the current speed, but the speed computed in the last step segment
@@ -29,6 +29,15 @@
   #define SEGMENT_BUFFER_SIZE 10
 #endif
 
+#ifndef SEGMENT_PREP_THRESHOLD
+  #define SEGMENT_PREP_THRESHOLD (SEGMENT_BUFFER_SIZE / 2) // Segment prep interrupt is requested at or below this buffer depth.
+#endif
+
+#ifdef STEP_GENERATOR_DDA
+  #define DDA_PHASE_BITS 30
+  #define DDA_PHASE_ONE (1UL << DDA_PHASE_BITS) // DDA phase of one step
+#endif
+
 typedef enum {
     SquaringMode_Both = 0,
     SquaringMode_A,
@@ -52,7 +61,12 @@ typedef struct st_block {
     char *message;                     // Message to be displayed when block is executed
     output_command_t *output_commands; // Output commands (linked list) to be performed when block is executed
     bool dynamic_rpm;                  // Tracks motions that require dynamic RPM adjustment
-    bool backlash_motion;
+#ifdef SPECIALIZED_STEPPER_ISR
+    uint_fast8_t traced_axes;          // Number of axes processed by the line tracer, highest moving axis + 1
+#endif
+#ifdef LASER_RASTER_MODE
+    laser_raster_t *raster;            // Scanline with laser power per pixel, freed when the block is reused
+#endif
 } st_block_t;
 
 typedef struct {
@@ -67,9 +81,15 @@ typedef struct {
     float spindle_rpm;              // Spindle RPM to be set at the start of the segment execution
 #endif
     bool update_rpm;                // True if set spindle speed at the start of the segment execution
+#ifdef LASER_POWER_RATE_SYNC
+    int32_t pwm_delta;              // PWM change per LASER_POWER_RATE_SYNC_TICKS ticks in 24.8 fixed point format, 0 for constant power
+#endif
     bool spindle_sync;              // True if block is spindle synchronized
     bool cruising;                  // True when in cruising part of profile, only set for spindle synced moves
     uint_fast8_t amass_level;       // Indicates AMASS level for the ISR to execute this segment
+#ifdef STEP_GENERATOR_DDA
+    uint32_t dda_rate[N_AXIS];      // Per axis DDA phase increment per ISR tick, a step is one DDA_PHASE_ONE of phase
+#endif
 } segment_t;
 
 // Stepper ISR data struct. Contains the running data for the main stepper ISR.
@@ -94,12 +114,33 @@ typedef struct {
     uint32_t steps[N_AXIS];
     uint_fast8_t amass_level;       // AMASS level for this segment
 //    uint_fast16_t spindle_pwm;
-    uint_fast16_t step_count;       // Steps remaining in line segment motion
+    uint_fast16_t step_count;       // Steps remaining in line segment motion, ticks remaining with STEP_GENERATOR_DDA
     uint32_t step_event_count;
     st_block_t *exec_block;         // Pointer to the block data for the segment being executed
     segment_t *exec_segment;        // Pointer to the segment being executed
 } stepper_t;
 
+#ifdef ENABLE_STEPPER_TELEMETRY
+
+// Segment buffer underrun and planner starvation statistics.
+typedef struct {
+    uint32_t underruns;         // Segment buffer ran empty while the segment generator had planner blocks to prepare
+    uint32_t starved_underruns; // Segment buffer ran empty after the planner had run empty, the input did not keep up
+    uint32_t planner_empty;     // Segment generator ran out of planner blocks during motion
+    uint32_t last_underrun;     // Timestamp (ms) of last underrun of either kind, 0 if HAL does not provide ticks
+    uint32_t last_planner_empty; // Timestamp (ms) of last planner empty event, 0 if HAL does not provide ticks
+    uint_fast8_t min_segments;  // Minimum segment buffer depth seen while streaming
+    uint32_t min_buffered_ms;   // Minimum motion time queued in segment and planner buffers (ms)
+} st_telemetry_t;
+
+// Returns pointer to the segment buffer statistics.
+st_telemetry_t *st_get_telemetry (void);
+
+// Clears the segment buffer statistics.
+void st_reset_telemetry (void);
+
+#endif
+
 // Initialize and setup the stepper motor subsystem
 void stepper_init();
 
@@ -112,6 +153,16 @@ void st_go_idle();
 // Reset the stepper subsystem variables
 void st_reset();
 
+#ifdef ENABLE_BACKLASH_COMPENSATION
+// Initialize backlash compensation from settings, assumes last motion was in the homing pull-off direction.
+void st_backlash_init (void);
+#endif
+
+#ifdef INPUT_SHAPING
+// Initialize the input shaper from the axis shaper settings.
+void st_shaper_init (void);
+#endif
+
 // Called by spindle_set_state() to inform about RPM changes.
 void st_rpm_changed(float rpm);
 
@@ -124,6 +175,24 @@ void st_parking_restore_buffer();
 // Reloads step segment buffer. Called continuously by realtime execution system.
 void st_prep_buffer();
 
+// Returns the motion time queued in the segment buffer in microseconds.
+uint32_t st_get_buffered_time (void);
+
+#ifdef SEGMENT_PREP_IRQ
+
+// Defers segment prep requested from the low priority interrupt while the foreground modifies data used by it.
+// Calls may be nested.
+void st_prep_lock (void);
+void st_prep_unlock (void);
+
+// Segment prep interrupt handler, called via hal.stepper_prep_callback.
+void st_prep_irq_handler (void);
+
+#else
+#define st_prep_lock()
+#define st_prep_unlock()
+#endif
+
 // Called by planner_recalculate() when the executing block is updated by the new plan.
 void st_update_plan_block_parameters();
 
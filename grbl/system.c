@@ -256,6 +256,15 @@ status_code_t system_execute_line (char *line)
             break;
 
         case 'S': // Puts Grbl to sleep [IDLE/ALARM]
+          #ifdef ENABLE_STEPPER_TELEMETRY
+            if(line[2] == 'T' && (line[3] == '\0' || (line[3] == 'R' && line[4] == '\0'))) {
+                // Print segment buffer statistics, reset them if $STR.
+                report_stepper_telemetry();
+                if(line[3] == 'R')
+                    st_reset_telemetry();
+                break;
+            }
+          #endif
             if(!settings.flags.sleep_enable || !(line[2] == 'L' && line[3] == 'P' && line[4] == '\0'))
                 retval = Status_InvalidStatement;
             else if(!(sys.state == STATE_IDLE || sys.state == STATE_ALARM))
@@ -366,6 +375,18 @@ status_code_t system_execute_line (char *line)
                 retval = Status_IdleError;
             break;
 
+#ifdef HEIGHT_MAP_COMPENSATION
+        case 'Z': // Height map [IDLE]
+            retval = heightmap_command(&line[2]);
+            break;
+#endif
+
+#ifdef LASER_RASTER_MODE
+        case 'L': // Laser raster scanline, pixel data is case sensitive.
+            retval = raster_command(&lcline[2]);
+            break;
+#endif
+
 #ifdef DEBUGOUT
         case 'Q':
             hal.stream.write(uitoa((uint32_t)sizeof(settings_t)));
@@ -92,7 +92,8 @@ typedef enum {
     Alarm_HomingFailApproach = 9,
     Alarm_EStop = 10,
     Alarm_HomingRequried = 11,
-    Alarm_LimitsEngaged = 12
+    Alarm_LimitsEngaged = 12,
+    Alarm_Spindle = 13
 } alarm_code_t;
 
 typedef enum {
@@ -264,11 +265,33 @@ bool system_check_travel_limits(float *target);
 void system_apply_jog_limits (float *target);
 
 // Special handlers for setting and clearing Grbl's real-time execution flags.
+// Clearing returns the flags before they were cleared.
+// The flags are uint_fast16_t, check that atomics of that size are lock-free.
+#if defined(RT_FLAGS_LOCK_FREE)
+  #if UINT_FAST16_MAX == UINT16_MAX && __SIZEOF_SHORT__ == 2
+    #define RT_FLAGS_ATOMIC (__GCC_ATOMIC_SHORT_LOCK_FREE == 2)
+  #elif UINT_FAST16_MAX == UINT32_MAX && __SIZEOF_INT__ == 4
+    #define RT_FLAGS_ATOMIC (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+  #elif UINT_FAST16_MAX == UINT64_MAX && __SIZEOF_LONG__ == 8
+    #define RT_FLAGS_ATOMIC (__GCC_ATOMIC_LONG_LOCK_FREE == 2)
+  #elif UINT_FAST16_MAX == UINT64_MAX && __SIZEOF_LONG_LONG__ == 8
+    #define RT_FLAGS_ATOMIC (__GCC_ATOMIC_LLONG_LOCK_FREE == 2)
+  #endif
+#endif
+
+#if defined(RT_FLAGS_ATOMIC) && RT_FLAGS_ATOMIC
+#define system_set_exec_state_flag(mask) ((void)__atomic_fetch_or(&sys_rt_exec_state, (uint_fast16_t)(mask), __ATOMIC_ACQ_REL))
+#define system_clear_exec_state_flag(mask) __atomic_fetch_and(&sys_rt_exec_state, (uint_fast16_t)~(mask), __ATOMIC_ACQ_REL)
+#define system_clear_exec_states() __atomic_exchange_n(&sys_rt_exec_state, 0, __ATOMIC_ACQ_REL)
+#define system_set_exec_alarm(code) __atomic_exchange_n(&sys_rt_exec_alarm, (uint_fast16_t)(code), __ATOMIC_ACQ_REL)
+#define system_clear_exec_alarm() __atomic_exchange_n(&sys_rt_exec_alarm, 0, __ATOMIC_ACQ_REL)
+#else
 #define system_set_exec_state_flag(mask) hal.set_bits_atomic(&sys_rt_exec_state, (mask))
 #define system_clear_exec_state_flag(mask) hal.clear_bits_atomic(&sys_rt_exec_state, (mask))
 #define system_clear_exec_states() hal.set_value_atomic(&sys_rt_exec_state, 0)
 #define system_set_exec_alarm(code) hal.set_value_atomic(&sys_rt_exec_alarm, (uint_fast16_t)(code))
 #define system_clear_exec_alarm() hal.set_value_atomic(&sys_rt_exec_alarm, 0)
+#endif
 
 void control_interrupt_handler (control_signals_t signals);
 
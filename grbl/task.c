@@ -0,0 +1,93 @@
+/*
+  task.c - cooperative foreground task scheduler
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+#define PREP_STATES (STATE_CYCLE|STATE_HOLD|STATE_SAFETY_DOOR|STATE_HOMING|STATE_SLEEP|STATE_JOG)
+
+static task_t *tasks = NULL;
+
+void task_register (task_t *task)
+{
+    task_t **link = &tasks;
+
+    while(*link && (*link)->priority <= task->priority)
+        link = &(*link)->next;
+
+    task->next_run = 0;
+    task->overruns = 0;
+    task->next = *link;
+    *link = task;
+}
+
+void task_yield (void)
+{
+    static bool busy = false;
+
+    if(!busy && (sys.state & PREP_STATES)) {
+        busy = true;
+        st_prep_buffer();
+        busy = false;
+    }
+}
+
+void task_run (uint_fast16_t state)
+{
+    static bool running = false;
+
+    if(tasks == NULL)
+        return;
+
+    // High priority tasks, such as stream input polling, are run even when called from a task that
+    // blocks in protocol_execute_realtime(), e.g. a jog waiting for room in the planner buffer.
+    bool nested = running;
+    task_t *task = tasks;
+    uint32_t now = hal.get_elapsed_ticks ? hal.get_elapsed_ticks() : 0, elapsed;
+
+    running = true;
+
+    while(task && !(nested && task->priority != TaskPriority_High)) {
+
+        if((int32_t)(now - task->next_run) >= 0) {
+
+            if(task->priority != TaskPriority_High && (state & PREP_STATES)) {
+                task_yield();
+                // Defer if running the task may drain the segment buffer, it is full or out of blocks at this point.
+                if(task->priority == TaskPriority_Low && st_get_buffered_time() < (uint32_t)task->budget * 1000UL) {
+                    task = task->next;
+                    continue;
+                }
+            }
+
+            task->execute(state);
+
+            if(hal.get_elapsed_ticks) { // Without a time base periods and budgets are not enforced.
+                elapsed = hal.get_elapsed_ticks() - now;
+                if(elapsed > task->budget)
+                    task->overruns++;
+                now += elapsed;
+                task->next_run = now + task->period;
+            }
+        }
+
+        task = task->next;
+    }
+
+    if(!nested)
+        running = false;
+}
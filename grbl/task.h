@@ -0,0 +1,54 @@
+/*
+  task.h - cooperative foreground task scheduler
+  Part of Grbl
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef task_h
+#define task_h
+
+// Segment preparation is the hard deadline of the foreground: the step segment buffer must be refilled
+// before the stepper ISR drains it. Tasks are run after the segment buffer has been topped up and
+// lower priority tasks are deferred while the motion time buffered is less than their time budget.
+
+typedef enum {
+    TaskPriority_High = 0,  // Always run when due, e.g. stream input.
+    TaskPriority_Normal,    // Run when due, after the segment buffer is topped up.
+    TaskPriority_Low        // Deferred while the buffered motion time is less than the budget, e.g. network polling or file system scans.
+} task_priority_t;
+
+typedef void (*task_ptr)(uint_fast16_t state);
+
+typedef struct task {
+    task_ptr execute;           // Called with the current system state.
+    task_priority_t priority;
+    uint16_t period;            // Minimum time between runs in ms, 0 to run on every pass.
+    uint16_t budget;            // Worst case run time in ms.
+    uint32_t next_run;          // Set by the scheduler.
+    uint32_t overruns;          // Number of runs exceeding the budget, set by the scheduler.
+    struct task *next;          // Set by the scheduler.
+} task_t;
+
+// Adds a task, the task struct must be static. Tasks are kept ordered by priority.
+void task_register (task_t *task);
+
+// Runs due tasks. Called by the realtime execution system after the segment buffer is refilled.
+void task_run (uint_fast16_t state);
+
+// Tops up the step segment buffer when in motion. Long running foreground code, such as report loops,
+// EEPROM writes and file system scans, should call this between chunks of work.
+void task_yield (void);
+
+#endif
@@ -29,7 +29,6 @@
 
 #define A_MOTOR X_AXIS // Must be X_AXIS
 #define B_MOTOR Y_AXIS // Must be Y_AXIS
-#define MAX_SEG_LENGTH_MM 2.0f
 
 typedef struct {
     int32_t width;
@@ -91,58 +90,17 @@ static void wp_plan_target_to_steps (int32_t *target_steps, float *target)
     target_steps[B_MOTOR] = wp_convert_to_b_motor_steps(target);
 }
 
-// Wall plotter is circular in motion, so long lines must be divided up
+// Lines are planned as single blocks in cartesian space and the step segment generator converts
+// each step segment to motor steps, so there is no need to divide them up here.
 static bool wp_segment_line (float *target, plan_line_data_t *pl_data, bool init)
 {
-    static uint_fast16_t iterations;
-    static bool segmented;
-    static float delta[N_AXIS], segment_target[N_AXIS];
-//    static plan_line_data_t plan;
-
-    uint_fast8_t idx = N_AXIS;
-
-    if(init) {
-
-        float max_delta = 0.0f;
-
-        do {
-            idx--;
-            delta[idx] = target[idx] - gc_state.position[idx];
-            max_delta = max(max_delta, fabsf(delta[idx]));
-        } while(idx);
-
-        if((segmented = !(pl_data->condition.rapid_motion || pl_data->condition.jog_motion) &&
-                           max_delta > MAX_SEG_LENGTH_MM && !(delta[X_AXIS] == 0.0f && delta[Y_AXIS] == 0.0f))) {
-
-            idx = N_AXIS;
-            iterations = (uint_fast16_t)ceilf(max_delta / MAX_SEG_LENGTH_MM);
-
-            memcpy(segment_target, gc_state.position, sizeof(segment_target));
-//            memcpy(&plan, pl_data, sizeof(plan_line_data_t));
-
-            do {
-                delta[--idx] /= (float)iterations;
-                target[idx] = gc_state.position[idx];
-            } while(idx);
-
-        } else
-            iterations = 1;
-
-        iterations++; // return at least one iteration
-
-    } else {
+    static uint_fast8_t iterations;
 
+    if(init)
+        iterations = 2; // return one iteration
+    else
         iterations--;
 
-        if(segmented && iterations) do {
-            idx--;
-            segment_target[idx] += delta[idx];
-            target[idx] = segment_target[idx];
-//            memcpy(pl_data, &plan, sizeof(plan_line_data_t));
-        } while(idx);
-
-    }
-
     return iterations != 0;
 }
 
@@ -251,6 +209,7 @@ void wall_plotter_init (void)
     kinematics.plan_target_to_steps = wp_plan_target_to_steps;
     kinematics.convert_array_steps_to_mpos = wp_convert_array_steps_to_mpos;
     kinematics.segment_line = wp_segment_line;
+    kinematics.segment_target_to_steps = wp_plan_target_to_steps;
 }
 
 #endif
@@ -40,7 +40,7 @@
 
 #define KEYBUF_SIZE 16
 
-static bool jogging = false, keyreleased = true;
+static bool jogging = false, stepJog = false, keyreleased = true;
 static char keybuf_buf[KEYBUF_SIZE];
 static jogmode_t jogMode = JogMode_Fast;
 static volatile uint32_t keybuf_head = 0, keybuf_tail = 0;
@@ -154,147 +154,159 @@ static char keypad_get_keycode (void)
     return data;
 }
 
-// BE WARNED: this function may be dangerous to use...
-static char *strrepl (char *str, int c, char *str3)
+// Sets the direction vector for a jog keycode, returns false if not a jog keycode.
+static bool keypad_jog_direction (char keycode, float *direction)
 {
-    char tmp[30];
-    char *s = strrchr(str, c);
-
-    while(s) {
-        strcpy(tmp, str3);
-        strcat(tmp, s + 1);
-        strcpy(s, tmp);
-        s = strrchr(str, c);
-    }
-
-    return str;
-}
-
-void keypad_process_keypress (uint_fast16_t state)
-{
-    bool addedGcode, jogCommand = false;
-    char command[30] = "", keycode = keypad_get_keycode();
+    memset(direction, 0, sizeof(float) * N_AXIS);
 
-    if(state == STATE_ESTOP)
-        return;
-
-    if(keycode)
-      switch(keycode) {
-
-        case 'M':                                   // Mist override
-            enqueue_accessory_override(CMD_OVERRIDE_COOLANT_MIST_TOGGLE);
-            break;
-
-        case 'C':                                   // Coolant override
-            enqueue_accessory_override(CMD_OVERRIDE_COOLANT_FLOOD_TOGGLE);
-            break;
-
-        case CMD_FEED_HOLD_LEGACY:                  // Feed hold
-            hal.stream.enqueue_realtime_command(CMD_FEED_HOLD);
-            break;
-
-        case CMD_CYCLE_START_LEGACY:                // Cycle start
-            hal.stream.enqueue_realtime_command(CMD_CYCLE_START);
-            break;
-
-        case '0':
-        case '1':
-        case '2':                                   // Set jog mode
-            jogMode = (jogmode_t)(keycode - '0');
-            break;
-
-        case 'h':                                   // "toggle" jog mode
-            jogMode = jogMode == JogMode_Step ? JogMode_Fast : (jogMode == JogMode_Fast ? JogMode_Slow : JogMode_Step);
-            break;
-
-        case 'H':                                   // Home axes
-            strcpy(command, "$H");
-            break;
+    switch(keycode) {
 
         case JOG_XR:                                // Jog X
-            strcpy(command, "$J=G91X?F");
+            direction[X_AXIS] = 1.0f;
             break;
 
         case JOG_XL:                                // Jog -X
-            strcpy(command, "$J=G91X-?F");
+            direction[X_AXIS] = -1.0f;
             break;
 
         case JOG_YF:                                // Jog Y
-            strcpy(command, "$J=G91Y?F");
+            direction[Y_AXIS] = 1.0f;
             break;
 
         case JOG_YB:                                // Jog -Y
-            strcpy(command, "$J=G91Y-?F");
+            direction[Y_AXIS] = -1.0f;
             break;
 
         case JOG_ZU:                                // Jog Z
-            strcpy(command, "$J=G91Z?F");
+            direction[Z_AXIS] = 1.0f;
             break;
 
         case JOG_ZD:                                // Jog -Z
-            strcpy(command, "$J=G91Z-?F");
+            direction[Z_AXIS] = -1.0f;
             break;
 
         case JOG_XRYF:                              // Jog XY
-            strcpy(command, "$J=G91X?Y?F");
+            direction[X_AXIS] = direction[Y_AXIS] = 1.0f;
             break;
 
         case JOG_XRYB:                              // Jog X-Y
-            strcpy(command, "$J=G91X?Y-?F");
+            direction[X_AXIS] = 1.0f;
+            direction[Y_AXIS] = -1.0f;
             break;
 
         case JOG_XLYF:                              // Jog -XY
-            strcpy(command, "$J=G91X-?Y?F");
+            direction[X_AXIS] = -1.0f;
+            direction[Y_AXIS] = 1.0f;
             break;
 
         case JOG_XLYB:                              // Jog -X-Y
-            strcpy(command, "$J=G91X-?Y-?F");
+            direction[X_AXIS] = direction[Y_AXIS] = -1.0f;
             break;
 
         case JOG_XRZU:                              // Jog XZ
-            strcpy(command, "$J=G91X?Z?F");
+            direction[X_AXIS] = direction[Z_AXIS] = 1.0f;
             break;
 
         case JOG_XRZD:                              // Jog X-Z
-            strcpy(command, "$J=G91X?Z-?F");
+            direction[X_AXIS] = 1.0f;
+            direction[Z_AXIS] = -1.0f;
             break;
 
         case JOG_XLZU:                              // Jog -XZ
-            strcpy(command, "$J=G91X-?Z?F");
+            direction[X_AXIS] = -1.0f;
+            direction[Z_AXIS] = 1.0f;
             break;
 
         case JOG_XLZD:                              // Jog -X-Z
-            strcpy(command, "$J=G91X-?Z-?F");
+            direction[X_AXIS] = direction[Z_AXIS] = -1.0f;
             break;
+
+        default:
+            return false;
     }
 
-    if(command[0] != '\0') {
+    return true;
+}
+
+void keypad_process_keypress (uint_fast16_t state)
+{
+    char command[40] = "", keycode = keypad_get_keycode();
+    float direction[N_AXIS];
+
+    if(state == STATE_ESTOP)
+        return;
+
+    if(keycode)
+      switch(keycode) {
+
+        case 'M':                                   // Mist override
+            enqueue_accessory_override(CMD_OVERRIDE_COOLANT_MIST_TOGGLE);
+            break;
+
+        case 'C':                                   // Coolant override
+            enqueue_accessory_override(CMD_OVERRIDE_COOLANT_FLOOD_TOGGLE);
+            break;
 
-        // add distance and speed to jog commands
-        if((jogCommand = (command[0] == '$' && command[1] == 'J'))) switch(jogMode) {
+        case CMD_FEED_HOLD_LEGACY:                  // Feed hold
+            hal.stream.enqueue_realtime_command(CMD_FEED_HOLD);
+            break;
 
-            case JogMode_Slow:
-                strrepl(command, '?', ftoa(driver_settings.jog.slow_distance, 0));
-                strcat(command, ftoa(driver_settings.jog.slow_speed, 0));
-                break;
+        case CMD_CYCLE_START_LEGACY:                // Cycle start
+            hal.stream.enqueue_realtime_command(CMD_CYCLE_START);
+            break;
 
-            case JogMode_Step:
-                strrepl(command, '?', ftoa(driver_settings.jog.step_distance, 3));
-                strcat(command, ftoa(driver_settings.jog.step_speed, 0));
-                break;
+        case '0':
+        case '1':
+        case '2':                                   // Set jog mode
+            jogMode = (jogmode_t)(keycode - '0');
+            break;
 
-            default:
-                strrepl(command, '?', ftoa(driver_settings.jog.fast_distance, 0));
-                strcat(command, ftoa(driver_settings.jog.fast_speed, 0));
-                break;
+        case 'h':                                   // "toggle" jog mode
+            jogMode = jogMode == JogMode_Step ? JogMode_Fast : (jogMode == JogMode_Fast ? JogMode_Slow : JogMode_Step);
+            break;
 
-        }
+        case 'H':                                   // Home axes
+            strcpy(command, "$H");
+            break;
 
-        if(!(jogCommand && keyreleased)) { // key still pressed? - do not execute jog command if released!
-            addedGcode = hal.protocol_enqueue_gcode((char *)command);
-            jogging = jogging || (jogCommand && addedGcode);
-        }
+        default:
+            if(keypad_jog_direction(keycode, direction) && !keyreleased) { // key still pressed? - do not jog if released!
+
+                switch(jogMode) {
+
+                    case JogMode_Slow:
+                        jogging = mc_jog_continuous(direction, driver_settings.jog.slow_speed, driver_settings.jog.slow_distance) == Status_OK;
+                        break;
+
+                    case JogMode_Step:
+                        {
+                            uint_fast8_t idx;
+
+                            strcpy(command, "$J=G91");
+                            for(idx = 0; idx < N_AXIS; idx++) {
+                                if(direction[idx] != 0.0f) {
+                                    strcat(command, axis_letter[idx]);
+                                    strcat(command, ftoa(direction[idx] * driver_settings.jog.step_distance, 3));
+                                }
+                            }
+                            strcat(command, "F");
+                            strcat(command, ftoa(driver_settings.jog.step_speed, 0));
+                            if(hal.protocol_enqueue_gcode((char *)command))
+                                jogging = stepJog = true;
+                            *command = '\0';
+                        }
+                        break;
+
+                    default:
+                        jogging = mc_jog_continuous(direction, driver_settings.jog.fast_speed, driver_settings.jog.fast_distance) == Status_OK;
+                        break;
+                }
+            }
+            break;
     }
+
+    if(command[0] != '\0')
+        hal.protocol_enqueue_gcode((char *)command);
 }
 
 ISR_CODE void keypad_keyclick_handler (bool keydown)
@@ -306,7 +318,11 @@ ISR_CODE void keypad_keyclick_handler (bool keydown)
 
     else if(jogging) {
         jogging = false;
-        hal.stream.enqueue_realtime_command(CMD_JOG_CANCEL);
+        if(stepJog) {
+            stepJog = false;
+            hal.stream.enqueue_realtime_command(CMD_JOG_CANCEL);
+        } else
+            mc_jog_continuous_stop(); // Stops within the deceleration distance, no buffer flush required.
         keybuf_tail = keybuf_head = 0; // flush keycode buffer
     }
 }
@@ -76,7 +76,7 @@ static file_t file = {
 
 static bool frewind = false;
 static io_stream_t active_stream;
-static driver_reset_ptr driver_reset = NULL;
+static hook_t report_hook, reset_hook;
 //static report_t active_reports;
 
 #ifdef __MSP432E401Y__
@@ -177,6 +177,8 @@ static FRESULT scan_dir (char *path, uint_fast8_t depth, char *buf)
             sprintf(buf, "[FILE:%s/%s|SIZE:%u%s]\r\n", path, get_name(&fno), (uint32_t)fno.fsize, status == Filename_Invalid ? "|UNUSABLE" : "");
             hal.stream.write(buf);
         }
+
+        task_yield();
     }
 
     if((subdirs = (subdirs && --depth)))
@@ -193,6 +195,7 @@ static FRESULT scan_dir (char *path, uint_fast8_t depth, char *buf)
             if(pathlen + strlen(get_name(&fno)) > (MAX_PATHLEN - 1))
                 break;
             sprintf(&path[pathlen], "/%s", get_name(&fno));
+            task_yield();
             if((res = scan_dir(path, depth, buf)) != FR_OK)
                 break;
             path[pathlen] = '\0';
@@ -284,7 +287,7 @@ static void sdcard_end_job (void)
     file_close();
     memcpy(&hal.stream, &active_stream, sizeof(io_stream_t));   // Restore stream pointers
     hal.stream.reset_read_buffer();                             // and flush input buffer
-    hal.driver_rt_report = NULL;
+    hook_remove(&hooks.realtime_report, &report_hook);
     hal.state_change_requested = NULL;
     hal.report.status_message = report_status_message;
     hal.report.feedback_message = report_feedback_message;
@@ -437,7 +440,7 @@ static status_code_t sdcard_parse (uint_fast16_t state, char *line, char *lcline
 #else
                     hal.stream.suspend_read = NULL;                             // ...
 #endif
-                    hal.driver_rt_report = sdcard_report;                       // Add percent complete to real time report
+                    hook_add(&hooks.realtime_report, &report_hook);             // Add percent complete to real time report
                     hal.report.status_message = trap_status_report;             // Redirect status message and feedback message
                     hal.report.feedback_message = trap_feedback_message;        // reports here
                     retval = Status_OK;
@@ -464,14 +467,13 @@ static void sdcard_reset (void)
         }
         sdcard_end_job();
     }
-
-    driver_reset();
 }
 
 void sdcard_init (void)
 {
-    driver_reset = hal.driver_reset;
-    hal.driver_reset = sdcard_reset;
+    report_hook.realtime_report = sdcard_report;
+    reset_hook.reset = sdcard_reset;
+    hook_add(&hooks.reset, &reset_hook);
     hal.driver_sys_command_execute = sdcard_parse;
 }
 
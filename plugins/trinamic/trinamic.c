@@ -50,8 +50,6 @@ static char sbuf[65]; // string buffer for reports
 static TMC2130_t stepper[N_AXIS];
 static axes_signals_t homing = {0}, otpw_triggered = {0};
 static limits_get_state_ptr limits_get_state = NULL;
-static void (*hal_stepper_pulse_start)(stepper_t *stepper) = NULL;
-static void (*hal_execute_realtime)(uint_fast16_t state) = NULL;
 static struct {
     axes_signals_t axes;
     bool raw;
@@ -334,8 +332,6 @@ static void report_sg_status (uint_fast16_t state)
         hal.stream.write(uitoa((uint32_t)stepper[report.sg_status_axis].drv_status.reg.sg_result));
         hal.stream.write("]\r\n");
     }
-    if(hal_execute_realtime)
-        hal_execute_realtime(state);
 }
 
 static void report_sg_params (void)
@@ -347,7 +343,7 @@ static void report_sg_params (void)
 static void stepper_pulse_start (stepper_t *motors)
 {
     static uint32_t step_count = 0;
-    hal_stepper_pulse_start(motors);
+
     report.sg_status_axis = 0;
 
     if(motors->step_outbits.x) {
@@ -359,6 +355,9 @@ static void stepper_pulse_start (stepper_t *motors)
     }
 }
 
+static hook_t sg_status_hook = { .execute_realtime = report_sg_status };
+static hook_t sg_step_hook = { .step_pulse = stepper_pulse_start };
+
 // Enable/disable stallGuard
 static void stallGuard_enable (uint32_t axis, bool enable)
 {
@@ -543,18 +542,13 @@ void trinamic_MCodeExecute (uint_fast16_t state, parser_block_t *gc_block)
 
         case Trinamic_DebugReport:
             if(report.sg_status_enable) {
-                if(hal.execute_realtime != report_sg_status) {
-                    hal_execute_realtime = hal.execute_realtime;
-                    hal.execute_realtime = report_sg_status;
-                    hal_stepper_pulse_start = hal.stepper_pulse_start;
-                    hal.stepper_pulse_start = stepper_pulse_start;
-                }
+                hook_add(&hooks.execute_realtime, &sg_status_hook);
+                hook_add(&hooks.step_pulse, &sg_step_hook);
                 stepper[report.sg_status_axis].coolconf.reg.sfilt = report.sfilt;
                 TMC2130_WriteRegister(&stepper[report.sg_status_axis], (TMC2130_datagram_t *)&stepper[report.sg_status_axis].coolconf);
-            } else if(hal.execute_realtime == report_sg_status) {
-                hal.execute_realtime = NULL;
-                hal.execute_realtime = hal_execute_realtime;
-                hal.stepper_pulse_start = hal_stepper_pulse_start;
+            } else {
+                hook_remove(&hooks.step_pulse, &sg_step_hook);
+                hook_remove(&hooks.execute_realtime, &sg_status_hook);
             }
             write_debug_report();
             break;
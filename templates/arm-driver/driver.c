@@ -14,10 +14,16 @@
 
 #include "grbl/grbl.h"
 
+// Uncomment to measure the stepper interrupt execution time with the DWT cycle counter.
+// The longest time since the previous report is added to the real time report as |Cyc:<cycles>.
+// NOTE: this adds a few cycles of overhead, use for benchmarking only.
+//#define STEPPER_ISR_CYCLES
+
 static bool pwmEnabled = false, IOInitDone = false;
 static axes_signals_t next_step_outbits;
 static spindle_pwm_t spindle_pwm;
 static delay_t delay = { .ms = 1, .callback = NULL }; // NOTE: initial ms set to 1 for "resetting" systick timer on startup
+static volatile uint32_t elapsed_ticks = 0;
 
 // Inverts the probe pin state depending on user settings and probing cycle mode.
 static uint8_t probe_invert;
@@ -37,6 +43,20 @@ static void limit_isr (void);
 static void control_isr (void);
 static void systick_isr (void);
 
+#ifdef STEPPER_ISR_CYCLES
+
+static volatile uint32_t stepper_isr_cycles = 0;
+
+static void report_stepper_isr_cycles (stream_write_ptr stream_write, report_tracking_flags_t report)
+{
+    stream_write("|Cyc:");
+    stream_write(uitoa(stepper_isr_cycles));
+    stepper_isr_cycles = 0;
+}
+
+static hook_t stepper_isr_cycles_hook = { .realtime_report = report_stepper_isr_cycles };
+
+#endif
 
 // Millisecond resolution delay function
 // Will return immediately if a callback function is provided
@@ -44,7 +64,6 @@ static void driver_delay_ms (uint32_t ms, void (*callback)(void))
 {
     if(ms) {
         delay.ms = ms;
-        // SYSTICK_ENABLE(); // Enable systick timer
         if(!(delay.callback = callback))
             while(delay.ms);
     } else {
@@ -57,6 +76,12 @@ static void driver_delay_ms (uint32_t ms, void (*callback)(void))
     }
 }
 
+// Returns milliseconds elapsed since startup, the systick timer is kept running for this.
+static uint32_t getElapsedTicks (void)
+{
+    return elapsed_ticks;
+}
+
 
 // Set stepper pulse output pins.
 // step_outbits.value (or step_outbits.mask) are: bit0 -> X, bit1 -> Y...
@@ -147,6 +172,17 @@ static void stepperPulseStart (stepper_t *stepper)
 
 // Start a stepper pulse, delay version
 // stepper_t struct is defined in grbl/stepper.h
+#ifdef SEGMENT_PREP_IRQ
+
+// Pends the low priority segment prep interrupt, PendSV is used here.
+// NOTE: use an unused peripheral interrupt instead if PendSV is claimed by a RTOS.
+static void stepperPrepRequest (void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+#endif
+
 static void stepperPulseStartDelayed (stepper_t *stepper)
 {
     if(stepper->new_block) {
@@ -164,9 +200,11 @@ static void stepperPulseStartDelayed (stepper_t *stepper)
 // Enable/disable limit pins interrupt.
 // NOTE: the homing parameter is indended for configuring advanced
 //        stepper drivers for sensorless homing.
+//       When homing the interrupt is enabled regardless of the hard limits setting
+//        since driver_cap.limits_homing_irq is set, the core uses it for latching the switch positions.
 static void limitsEnable (bool on, bool homing)
 {
-//    if (on && settings.limits.flags.hard_enabled)
+//    if (on && (homing || settings.limits.flags.hard_enabled))
         // GPIO_IRQ_ENABLE(LIMITS_PORT); // Enable limit pins change interrupts.
 //    else
         // GPIO_IRQ_DISABLE(LIMITS_PORT); // Disable limit pins change interrupts.
@@ -528,10 +566,17 @@ bool driver_init (void)
 
     SysTick->LOAD = (SystemCoreClock / 1000) - 1;
     SysTick->VAL = 0;
-    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk;
+    SysTick->CTRL |= SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_TICKINT_Msk|SysTick_CTRL_ENABLE_Msk;
 
     // end systick timer setup.
 
+#ifdef STEPPER_ISR_CYCLES
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    hook_add(&hooks.realtime_report, &stepper_isr_cycles_hook);
+#endif
+
     // Enable EEPROM peripheral here if available.
 
     // Enable lazy stacking of FPU registers here if a FPU is available.
@@ -544,6 +589,7 @@ bool driver_init (void)
     hal.f_step_timer = SystemCoreClock; // NOTE: SystemCoreClock is a CMSIS definition, ...
     hal.rx_buffer_size = RX_BUFFER_SIZE;
     hal.delay_ms = driver_delay_ms;
+    hal.get_elapsed_ticks = getElapsedTicks;
     hal.settings_changed = settings_changed;
 
     hal.stepper_wake_up = stepperWakeUp;
@@ -551,6 +597,11 @@ bool driver_init (void)
     hal.stepper_enable = stepperEnable;
     hal.stepper_cycles_per_tick = stepperCyclesPerTick;
     hal.stepper_pulse_start = stepperPulseStart;
+#ifdef SEGMENT_PREP_IRQ
+    // Segment prep interrupt must have lower priority than the stepper interrupts.
+    NVIC_SetPriority(PendSV_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+    hal.stepper_prep_request = stepperPrepRequest;
+#endif
 
     hal.limits_enable = limitsEnable;
     hal.limits_get_state = limitsGetState;
@@ -610,12 +661,13 @@ bool driver_init (void)
     hal.driver_cap.amass_level = 3;
     hal.driver_cap.control_pull_up = On;
     hal.driver_cap.limits_pull_up = On;
+    hal.driver_cap.limits_homing_irq = On;
     hal.driver_cap.probe_pull_up = On;
 
 
     // No need to move version check before init.
     // Compiler will fail any signature mismatch for existing entries.
-    return hal.version == 6;
+    return hal.version == 7;
 }
 
 /* interrupt handlers */
@@ -623,10 +675,29 @@ bool driver_init (void)
 // Main stepper driver.
 static void stepper_driver_isr (void)
 {
+#ifdef STEPPER_ISR_CYCLES
+    uint32_t cycles = DWT->CYCCNT;
+#endif
+
     // STEPPERTIMER_IRQ_CLEAR(); // Clear stepper timer interrupt.
     hal.stepper_interrupt_callback();
+
+#ifdef STEPPER_ISR_CYCLES
+    if((cycles = DWT->CYCCNT - cycles) > stepper_isr_cycles)
+        stepper_isr_cycles = cycles;
+#endif
 }
 
+#ifdef SEGMENT_PREP_IRQ
+
+// Low priority segment prep interrupt.
+void PendSV_Handler (void)
+{
+    hal.stepper_prep_callback();
+}
+
+#endif
+
 /* The Stepper Port Reset Interrupt: This interrupt handles the falling edge of the step
    pulse. This should always trigger before the next general stepper driver interrupt and independently
    finish, if stepper driver interrupts is disabled after completing a move.
@@ -671,8 +742,9 @@ static void control_isr (void)
 // Interrupt handler for 1 ms interval timer
 static void systick_isr (void)
 {
-    if(!(--delay.ms)) {
-        // SYSTICK_DISABLE; // Disable systick timer
+    elapsed_ticks++;
+
+    if(delay.ms && !(--delay.ms)) {
         if(delay.callback) {
             delay.callback();
             delay.callback = NULL;
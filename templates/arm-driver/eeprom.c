@@ -51,8 +51,11 @@ void eepromWriteBlockWithChecksum (uint32_t destination, uint8_t *source, uint32
     uint8_t *data = source;
     uint32_t remaining = size;
 
-    for(; remaining > 0; remaining--)
+    for(; remaining > 0; remaining--) {
         eepromPutByte(destination++, *data++);
+        if(!(remaining & 0x0F))
+            task_yield(); // Keep the segment buffer topped up, byte writes are slow.
+    }
 
     eepromPutByte(destination, calc_checksum(source, size));
 }
@@ -0,0 +1,36 @@
+/*
+  stepper_inline.h - Step pulse output bound to the stepper ISR at compile time
+
+  Template driver code for ARM processors
+
+  Part of GrblHAL
+
+  By Terje Io, public domain
+
+*/
+
+// Included by grbl/stepper.c when HAL_STEPPER_INLINE is defined as "stepper_inline.h" in grbl/config.h,
+// the driver directory must then be on the include path. The functions below are called directly by the
+// stepper ISR instead of via hal.stepper_pulse_start and hal.stepper_cycles_per_tick.
+// NOTE: If the driver supports step pulse delay the delayed version has to be handled here, e.g. by
+//       testing a flag set by settings_changed().
+
+// Sets up stepper driver interrupt timeout, see stepperCyclesPerTick() in driver.c.
+static inline void driver_stepper_cycles_per_tick (uint32_t cycles_per_tick)
+{
+    // STEPPERTIMER_LOAD(cycles_per_tick);  // Set the stepper timer timeout time.
+}
+
+// Start a stepper pulse, see stepperPulseStart() in driver.c.
+static inline void driver_stepper_pulse_start (stepper_t *stepper)
+{
+    if(stepper->new_block) {
+        stepper->new_block = false;
+        // DIRECTION_PORT = stepper->dir_outbits.mask ^ settings.steppers.dir_invert.mask;
+    }
+
+    if(stepper->step_outbits.value) {
+        // STEP_PORT = stepper->step_outbits.mask ^ settings.steppers.step_invert.mask;
+        // STEPPULSETIMER_START();        // Start step pulse timer.
+    }
+}